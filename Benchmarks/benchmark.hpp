@@ -0,0 +1,74 @@
+#pragma once
+
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include "../Tests/test_system.hpp"
+
+
+// The hardware of the test system, with the bundled ROMs run headless a frame at a time
+// Each benchmark times the current implementation against what it replaced or against its alternatives
+class BenchmarkSystem : public TestSystem {
+public:
+    long long total_instructions = 0;
+
+
+    static BenchmarkSystem& get_instance() {
+        static BenchmarkSystem benchmark_system;
+        return benchmark_system;
+    }
+
+
+    void insert_rom(std::string rom_path) {
+        TestSystem::insert_rom(rom_path);
+        total_instructions = 0;
+    }
+
+
+    // Only instructions which actually ran are counted, not the 4 tick steps skipped over in halt mode
+    template <typename RunInstruction>
+    void run_frames(int total_frames, RunInstruction run_instruction) {
+        for (int frame = 0; frame < total_frames; frame++) {
+            update_input(frame);
+
+            run_frame([&](int max_skipped_ticks) {
+                bool was_halted = cpu.is_halted;
+                int last_instruction_ticks = run_instruction(max_skipped_ticks);
+                if (!was_halted) total_instructions += cpu.last_instruction_count;
+                return last_instruction_ticks;
+            });
+        }
+    }
+};
+
+
+// The fastest of several runs, which is the least disturbed by the rest of the machine
+template <typename Function>
+double get_fastest_time(Function function, int total_runs = 5) {
+    double fastest_time = 0;
+
+    for (int i = 0; i < total_runs; i++) {
+        auto start_time = std::chrono::steady_clock::now();
+        function();
+        double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+        if (i == 0 || time < fastest_time) fastest_time = time;
+    }
+
+    return fastest_time;
+}
+
+
+// ROMs can be passed on the command line, otherwise the bundled ROMs are used
+inline std::vector<std::string> get_rom_paths(int argc, char** argv) {
+    if (argc > 1) return std::vector<std::string>(argv + 1, argv + argc);
+    return {ROM_DIRECTORY "Snake.gb", ROM_DIRECTORY "Wordle.gb", ROM_DIRECTORY "Flappy Bird Clone.gb"};
+}
+
+
+inline void print_result(std::string name, double count, std::string unit, double time) {
+    std::cout << "    " << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(2);
+    std::cout << std::setw(10) << count / time / 1e6 << " M" << unit << "/s" << std::endl;
+}
\ No newline at end of file
@@ -0,0 +1,356 @@
+#include <iostream>
+#include "benchmark.hpp"
+#include "Opcodes/alu_opcodes.hpp"
+#include "Opcodes/load_opcodes.hpp"
+#include "Opcodes/func_opcodes.hpp"
+#include "Opcodes/jump_opcodes.hpp"
+#include "Opcodes/misc_opcodes.hpp"
+#include "Opcodes/bitmanip_opcodes.hpp"
+
+
+// Compares the interpreter's opcode dispatch on the bundled ROMs, in emulated instructions per second
+// The block cache is turned off, so that every instruction is fetched and then decoded by one of CPU::execute's alternatives:
+// the handler table, which makes an indexed call through CPU::opcode_handlers (the default),
+// and computed goto, which makes an indexed jump into CPU::execute_computed_goto where the handlers are expanded inline (built with ANTBOY_COMPUTED_GOTO)
+// Both are measured against the two switches CPU::execute decoded with before the handler table, which are kept here as execute_switch
+
+
+static BenchmarkSystem& benchmark_system = BenchmarkSystem::get_instance();
+static const int total_frames = 1200;
+
+
+// CPU::execute as it was before the handler table, with one switch for unprefixed opcodes and a second for prefixed opcodes after the 0xCB fetch
+// The cases call the same opcode functions as CPU::execute_opcode, so only the decoding differs from the other dispatchers
+static int execute_switch(Hardware::CPU& cpu, U8 opcode) {
+
+    // Enable interrupts after delay
+    if (cpu.can_enable_interrupts) {
+        cpu.is_interrupt_master_enabled = true;
+        cpu.can_enable_interrupts = false;
+    }
+
+    // Decoding prefixed opcodes, which are all generated from their encoding
+    if (opcode == 0xCB) {
+        #define PREFIXED_CASE(opcode) case opcode: return Opcodes::CB_opcode<opcode>(cpu);
+        #define PREFIXED_ROW(row) PREFIXED_CASE(row + 0x0) PREFIXED_CASE(row + 0x1) PREFIXED_CASE(row + 0x2) PREFIXED_CASE(row + 0x3) \
+            PREFIXED_CASE(row + 0x4) PREFIXED_CASE(row + 0x5) PREFIXED_CASE(row + 0x6) PREFIXED_CASE(row + 0x7) PREFIXED_CASE(row + 0x8) \
+            PREFIXED_CASE(row + 0x9) PREFIXED_CASE(row + 0xA) PREFIXED_CASE(row + 0xB) PREFIXED_CASE(row + 0xC) PREFIXED_CASE(row + 0xD) \
+            PREFIXED_CASE(row + 0xE) PREFIXED_CASE(row + 0xF)
+
+        switch (cpu.fetch()) {
+            PREFIXED_ROW(0x00) PREFIXED_ROW(0x10) PREFIXED_ROW(0x20) PREFIXED_ROW(0x30) PREFIXED_ROW(0x40) PREFIXED_ROW(0x50) PREFIXED_ROW(0x60) PREFIXED_ROW(0x70)
+            PREFIXED_ROW(0x80) PREFIXED_ROW(0x90) PREFIXED_ROW(0xA0) PREFIXED_ROW(0xB0) PREFIXED_ROW(0xC0) PREFIXED_ROW(0xD0) PREFIXED_ROW(0xE0) PREFIXED_ROW(0xF0)
+            default: return 0;
+        }
+
+        #undef PREFIXED_ROW
+        #undef PREFIXED_CASE
+    }
+
+    // Decoding unprefixed opcodes
+    switch (opcode) {
+        case 0x00: return Opcodes::NOP(cpu);
+        case 0x01: return Opcodes::LD_rr_u16(cpu, cpu.BC);
+        case 0x02: return Opcodes::LD_ptr_rr_A(cpu, cpu.BC);
+        case 0x03: return Opcodes::INC_rr(cpu, cpu.BC);
+        case 0x04: return Opcodes::INC_r(cpu, cpu.B);
+        case 0x05: return Opcodes::DEC_r(cpu, cpu.B);
+        case 0x06: return Opcodes::LD_r_u8(cpu, cpu.B);
+        case 0x07: return Opcodes::RLCA(cpu);
+        case 0x08: return Opcodes::LD_ptr_u16_SP(cpu);
+        case 0x09: return Opcodes::ADD_HL_rr(cpu, cpu.BC);
+        case 0x0A: return Opcodes::LD_A_ptr_rr(cpu, cpu.BC);
+        case 0x0B: return Opcodes::DEC_rr(cpu, cpu.BC);
+        case 0x0C: return Opcodes::INC_r(cpu, cpu.C);
+        case 0x0D: return Opcodes::DEC_r(cpu, cpu.C);
+        case 0x0E: return Opcodes::LD_r_u8(cpu, cpu.C);
+        case 0x0F: return Opcodes::RRCA(cpu);
+        case 0x11: return Opcodes::LD_rr_u16(cpu, cpu.DE);
+        case 0x12: return Opcodes::LD_ptr_rr_A(cpu, cpu.DE);
+        case 0x13: return Opcodes::INC_rr(cpu, cpu.DE);
+        case 0x14: return Opcodes::INC_r(cpu, cpu.D);
+        case 0x15: return Opcodes::DEC_r(cpu, cpu.D);
+        case 0x16: return Opcodes::LD_r_u8(cpu, cpu.D);
+        case 0x17: return Opcodes::RLA(cpu);
+        case 0x18: return Opcodes::JR_s8(cpu);
+        case 0x19: return Opcodes::ADD_HL_rr(cpu, cpu.DE);
+        case 0x1A: return Opcodes::LD_A_ptr_rr(cpu, cpu.DE);
+        case 0x1B: return Opcodes::DEC_rr(cpu, cpu.DE);
+        case 0x1C: return Opcodes::INC_r(cpu, cpu.E);
+        case 0x1D: return Opcodes::DEC_r(cpu, cpu.E);
+        case 0x1E: return Opcodes::LD_r_u8(cpu, cpu.E);
+        case 0x1F: return Opcodes::RRA(cpu);
+        case 0x20: return Opcodes::JR_cc_s8(cpu, Hardware::CPU::IS_NOT_ZERO);
+        case 0x21: return Opcodes::LD_rr_u16(cpu, cpu.HL);
+        case 0x22: return Opcodes::LDI_ptr_HL_A(cpu);
+        case 0x23: return Opcodes::INC_rr(cpu, cpu.HL);
+        case 0x24: return Opcodes::INC_r(cpu, cpu.H);
+        case 0x25: return Opcodes::DEC_r(cpu, cpu.H);
+        case 0x26: return Opcodes::LD_r_u8(cpu, cpu.H);
+        case 0x27: return Opcodes::DAA(cpu);
+        case 0x28: return Opcodes::JR_cc_s8(cpu, Hardware::CPU::IS_ZERO);
+        case 0x29: return Opcodes::ADD_HL_rr(cpu, cpu.HL);
+        case 0x2A: return Opcodes::LDI_A_ptr_HL(cpu);
+        case 0x2B: return Opcodes::DEC_rr(cpu, cpu.HL);
+        case 0x2C: return Opcodes::INC_r(cpu, cpu.L);
+        case 0x2D: return Opcodes::DEC_r(cpu, cpu.L);
+        case 0x2E: return Opcodes::LD_r_u8(cpu, cpu.L);
+        case 0x2F: return Opcodes::CPL(cpu);
+        case 0x30: return Opcodes::JR_cc_s8(cpu, Hardware::CPU::IS_NOT_CARRY);
+        case 0x31: return Opcodes::LD_SP_u16(cpu);
+        case 0x32: return Opcodes::LDD_ptr_HL_A(cpu);
+        case 0x33: return Opcodes::INC_SP(cpu);
+        case 0x34: return Opcodes::INC_ptr_HL(cpu);
+        case 0x35: return Opcodes::DEC_ptr_HL(cpu);
+        case 0x36: return Opcodes::LD_ptr_HL_u8(cpu);
+        case 0x37: return Opcodes::SCF(cpu);
+        case 0x38: return Opcodes::JR_cc_s8(cpu, Hardware::CPU::IS_CARRY);
+        case 0x39: return Opcodes::ADD_HL_SP(cpu);
+        case 0x3A: return Opcodes::LDD_A_ptr_HL(cpu);
+        case 0x3B: return Opcodes::DEC_SP(cpu);
+        case 0x3C: return Opcodes::INC_r(cpu, cpu.A);
+        case 0x3D: return Opcodes::DEC_r(cpu, cpu.A);
+        case 0x3E: return Opcodes::LD_r_u8(cpu, cpu.A);
+        case 0x3F: return Opcodes::CCF(cpu);
+        case 0x40: return Opcodes::LD_r_r(cpu, cpu.B, cpu.B);
+        case 0x41: return Opcodes::LD_r_r(cpu, cpu.B, cpu.C);
+        case 0x42: return Opcodes::LD_r_r(cpu, cpu.B, cpu.D);
+        case 0x43: return Opcodes::LD_r_r(cpu, cpu.B, cpu.E);
+        case 0x44: return Opcodes::LD_r_r(cpu, cpu.B, cpu.H);
+        case 0x45: return Opcodes::LD_r_r(cpu, cpu.B, cpu.L);
+        case 0x46: return Opcodes::LD_r_ptr_HL(cpu, cpu.B);
+        case 0x47: return Opcodes::LD_r_r(cpu, cpu.B, cpu.A);
+        case 0x48: return Opcodes::LD_r_r(cpu, cpu.C, cpu.B);
+        case 0x49: return Opcodes::LD_r_r(cpu, cpu.C, cpu.C);
+        case 0x4A: return Opcodes::LD_r_r(cpu, cpu.C, cpu.D);
+        case 0x4B: return Opcodes::LD_r_r(cpu, cpu.C, cpu.E);
+        case 0x4C: return Opcodes::LD_r_r(cpu, cpu.C, cpu.H);
+        case 0x4D: return Opcodes::LD_r_r(cpu, cpu.C, cpu.L);
+        case 0x4E: return Opcodes::LD_r_ptr_HL(cpu, cpu.C);
+        case 0x4F: return Opcodes::LD_r_r(cpu, cpu.C, cpu.A);
+        case 0x50: return Opcodes::LD_r_r(cpu, cpu.D, cpu.B);
+        case 0x51: return Opcodes::LD_r_r(cpu, cpu.D, cpu.C);
+        case 0x52: return Opcodes::LD_r_r(cpu, cpu.D, cpu.D);
+        case 0x53: return Opcodes::LD_r_r(cpu, cpu.D, cpu.E);
+        case 0x54: return Opcodes::LD_r_r(cpu, cpu.D, cpu.H);
+        case 0x55: return Opcodes::LD_r_r(cpu, cpu.D, cpu.L);
+        case 0x56: return Opcodes::LD_r_ptr_HL(cpu, cpu.D);
+        case 0x57: return Opcodes::LD_r_r(cpu, cpu.D, cpu.A);
+        case 0x58: return Opcodes::LD_r_r(cpu, cpu.E, cpu.B);
+        case 0x59: return Opcodes::LD_r_r(cpu, cpu.E, cpu.C);
+        case 0x5A: return Opcodes::LD_r_r(cpu, cpu.E, cpu.D);
+        case 0x5B: return Opcodes::LD_r_r(cpu, cpu.E, cpu.E);
+        case 0x5C: return Opcodes::LD_r_r(cpu, cpu.E, cpu.H);
+        case 0x5D: return Opcodes::LD_r_r(cpu, cpu.E, cpu.L);
+        case 0x5E: return Opcodes::LD_r_ptr_HL(cpu, cpu.E);
+        case 0x5F: return Opcodes::LD_r_r(cpu, cpu.E, cpu.A);
+        case 0x60: return Opcodes::LD_r_r(cpu, cpu.H, cpu.B);
+        case 0x61: return Opcodes::LD_r_r(cpu, cpu.H, cpu.C);
+        case 0x62: return Opcodes::LD_r_r(cpu, cpu.H, cpu.D);
+        case 0x63: return Opcodes::LD_r_r(cpu, cpu.H, cpu.E);
+        case 0x64: return Opcodes::LD_r_r(cpu, cpu.H, cpu.H);
+        case 0x65: return Opcodes::LD_r_r(cpu, cpu.H, cpu.L);
+        case 0x66: return Opcodes::LD_r_ptr_HL(cpu, cpu.H);
+        case 0x67: return Opcodes::LD_r_r(cpu, cpu.H, cpu.A);
+        case 0x68: return Opcodes::LD_r_r(cpu, cpu.L, cpu.B);
+        case 0x69: return Opcodes::LD_r_r(cpu, cpu.L, cpu.C);
+        case 0x6A: return Opcodes::LD_r_r(cpu, cpu.L, cpu.D);
+        case 0x6B: return Opcodes::LD_r_r(cpu, cpu.L, cpu.E);
+        case 0x6C: return Opcodes::LD_r_r(cpu, cpu.L, cpu.H);
+        case 0x6D: return Opcodes::LD_r_r(cpu, cpu.L, cpu.L);
+        case 0x6E: return Opcodes::LD_r_ptr_HL(cpu, cpu.L);
+        case 0x6F: return Opcodes::LD_r_r(cpu, cpu.L, cpu.A);
+        case 0x70: return Opcodes::LD_ptr_HL_r(cpu, cpu.B);
+        case 0x71: return Opcodes::LD_ptr_HL_r(cpu, cpu.C);
+        case 0x72: return Opcodes::LD_ptr_HL_r(cpu, cpu.D);
+        case 0x73: return Opcodes::LD_ptr_HL_r(cpu, cpu.E);
+        case 0x74: return Opcodes::LD_ptr_HL_r(cpu, cpu.H);
+        case 0x75: return Opcodes::LD_ptr_HL_r(cpu, cpu.L);
+        case 0x76: return Opcodes::HALT(cpu);
+        case 0x77: return Opcodes::LD_ptr_HL_r(cpu, cpu.A);
+        case 0x78: return Opcodes::LD_r_r(cpu, cpu.A, cpu.B);
+        case 0x79: return Opcodes::LD_r_r(cpu, cpu.A, cpu.C);
+        case 0x7A: return Opcodes::LD_r_r(cpu, cpu.A, cpu.D);
+        case 0x7B: return Opcodes::LD_r_r(cpu, cpu.A, cpu.E);
+        case 0x7C: return Opcodes::LD_r_r(cpu, cpu.A, cpu.H);
+        case 0x7D: return Opcodes::LD_r_r(cpu, cpu.A, cpu.L);
+        case 0x7E: return Opcodes::LD_r_ptr_HL(cpu, cpu.A);
+        case 0x7F: return Opcodes::LD_r_r(cpu, cpu.A, cpu.A);
+        case 0x80: return Opcodes::ADD_r(cpu, cpu.B);
+        case 0x81: return Opcodes::ADD_r(cpu, cpu.C);
+        case 0x82: return Opcodes::ADD_r(cpu, cpu.D);
+        case 0x83: return Opcodes::ADD_r(cpu, cpu.E);
+        case 0x84: return Opcodes::ADD_r(cpu, cpu.H);
+        case 0x85: return Opcodes::ADD_r(cpu, cpu.L);
+        case 0x86: return Opcodes::ADD_ptr_HL(cpu);
+        case 0x87: return Opcodes::ADD_r(cpu, cpu.A);
+        case 0x88: return Opcodes::ADC_r(cpu, cpu.B);
+        case 0x89: return Opcodes::ADC_r(cpu, cpu.C);
+        case 0x8A: return Opcodes::ADC_r(cpu, cpu.D);
+        case 0x8B: return Opcodes::ADC_r(cpu, cpu.E);
+        case 0x8C: return Opcodes::ADC_r(cpu, cpu.H);
+        case 0x8D: return Opcodes::ADC_r(cpu, cpu.L);
+        case 0x8E: return Opcodes::ADC_ptr_HL(cpu);
+        case 0x8F: return Opcodes::ADC_r(cpu, cpu.A);
+        case 0x90: return Opcodes::SUB_r(cpu, cpu.B);
+        case 0x91: return Opcodes::SUB_r(cpu, cpu.C);
+        case 0x92: return Opcodes::SUB_r(cpu, cpu.D);
+        case 0x93: return Opcodes::SUB_r(cpu, cpu.E);
+        case 0x94: return Opcodes::SUB_r(cpu, cpu.H);
+        case 0x95: return Opcodes::SUB_r(cpu, cpu.L);
+        case 0x96: return Opcodes::SUB_ptr_HL(cpu);
+        case 0x97: return Opcodes::SUB_r(cpu, cpu.A);
+        case 0x98: return Opcodes::SBC_r(cpu, cpu.B);
+        case 0x99: return Opcodes::SBC_r(cpu, cpu.C);
+        case 0x9A: return Opcodes::SBC_r(cpu, cpu.D);
+        case 0x9B: return Opcodes::SBC_r(cpu, cpu.E);
+        case 0x9C: return Opcodes::SBC_r(cpu, cpu.H);
+        case 0x9D: return Opcodes::SBC_r(cpu, cpu.L);
+        case 0x9E: return Opcodes::SBC_ptr_HL(cpu);
+        case 0x9F: return Opcodes::SBC_r(cpu, cpu.A);
+        case 0xA0: return Opcodes::AND_r(cpu, cpu.B);
+        case 0xA1: return Opcodes::AND_r(cpu, cpu.C);
+        case 0xA2: return Opcodes::AND_r(cpu, cpu.D);
+        case 0xA3: return Opcodes::AND_r(cpu, cpu.E);
+        case 0xA4: return Opcodes::AND_r(cpu, cpu.H);
+        case 0xA5: return Opcodes::AND_r(cpu, cpu.L);
+        case 0xA6: return Opcodes::AND_ptr_HL(cpu);
+        case 0xA7: return Opcodes::AND_r(cpu, cpu.A);
+        case 0xA8: return Opcodes::XOR_r(cpu, cpu.B);
+        case 0xA9: return Opcodes::XOR_r(cpu, cpu.C);
+        case 0xAA: return Opcodes::XOR_r(cpu, cpu.D);
+        case 0xAB: return Opcodes::XOR_r(cpu, cpu.E);
+        case 0xAC: return Opcodes::XOR_r(cpu, cpu.H);
+        case 0xAD: return Opcodes::XOR_r(cpu, cpu.L);
+        case 0xAE: return Opcodes::XOR_ptr_HL(cpu);
+        case 0xAF: return Opcodes::XOR_r(cpu, cpu.A);
+        case 0xB0: return Opcodes::OR_r(cpu, cpu.B);
+        case 0xB1: return Opcodes::OR_r(cpu, cpu.C);
+        case 0xB2: return Opcodes::OR_r(cpu, cpu.D);
+        case 0xB3: return Opcodes::OR_r(cpu, cpu.E);
+        case 0xB4: return Opcodes::OR_r(cpu, cpu.H);
+        case 0xB5: return Opcodes::OR_r(cpu, cpu.L);
+        case 0xB6: return Opcodes::OR_ptr_HL(cpu);
+        case 0xB7: return Opcodes::OR_r(cpu, cpu.A);
+        case 0xB8: return Opcodes::CP_r(cpu, cpu.B);
+        case 0xB9: return Opcodes::CP_r(cpu, cpu.C);
+        case 0xBA: return Opcodes::CP_r(cpu, cpu.D);
+        case 0xBB: return Opcodes::CP_r(cpu, cpu.E);
+        case 0xBC: return Opcodes::CP_r(cpu, cpu.H);
+        case 0xBD: return Opcodes::CP_r(cpu, cpu.L);
+        case 0xBE: return Opcodes::CP_ptr_HL(cpu);
+        case 0xBF: return Opcodes::CP_r(cpu, cpu.A);
+        case 0xC0: return Opcodes::RET_cc(cpu, Hardware::CPU::IS_NOT_ZERO);
+        case 0xC1: return Opcodes::POP_rr(cpu, cpu.BC);
+        case 0xC2: return Opcodes::JP_cc_u16(cpu, Hardware::CPU::IS_NOT_ZERO);
+        case 0xC3: return Opcodes::JP_u16(cpu);
+        case 0xC4: return Opcodes::CALL_cc_u16(cpu, Hardware::CPU::IS_NOT_ZERO);
+        case 0xC5: return Opcodes::PUSH_rr(cpu, cpu.BC);
+        case 0xC6: return Opcodes::ADD_u8(cpu);
+        case 0xC7: return Opcodes::RST_n(cpu, 0);
+        case 0xC8: return Opcodes::RET_cc(cpu, Hardware::CPU::IS_ZERO);
+        case 0xC9: return Opcodes::RET(cpu);
+        case 0xCA: return Opcodes::JP_cc_u16(cpu, Hardware::CPU::IS_ZERO);
+        case 0xCC: return Opcodes::CALL_cc_u16(cpu, Hardware::CPU::IS_ZERO);
+        case 0xCD: return Opcodes::CALL_u16(cpu);
+        case 0xCE: return Opcodes::ADC_u8(cpu);
+        case 0xCF: return Opcodes::RST_n(cpu, 1);
+        case 0xD0: return Opcodes::RET_cc(cpu, Hardware::CPU::IS_NOT_CARRY);
+        case 0xD1: return Opcodes::POP_rr(cpu, cpu.DE);
+        case 0xD2: return Opcodes::JP_cc_u16(cpu, Hardware::CPU::IS_NOT_CARRY);
+        case 0xD4: return Opcodes::CALL_cc_u16(cpu, Hardware::CPU::IS_NOT_CARRY);
+        case 0xD5: return Opcodes::PUSH_rr(cpu, cpu.DE);
+        case 0xD6: return Opcodes::SUB_u8(cpu);
+        case 0xD7: return Opcodes::RST_n(cpu, 2);
+        case 0xD8: return Opcodes::RET_cc(cpu, Hardware::CPU::IS_CARRY);
+        case 0xD9: return Opcodes::RETI(cpu);
+        case 0xDA: return Opcodes::JP_cc_u16(cpu, Hardware::CPU::IS_CARRY);
+        case 0xDC: return Opcodes::CALL_cc_u16(cpu, Hardware::CPU::IS_CARRY);
+        case 0xDE: return Opcodes::SBC_u8(cpu);
+        case 0xDF: return Opcodes::RST_n(cpu, 3);
+        case 0xE0: return Opcodes::LDH_ptr_u8_A(cpu);
+        case 0xE1: return Opcodes::POP_rr(cpu, cpu.HL);
+        case 0xE2: return Opcodes::LDH_ptr_C_A(cpu);
+        case 0xE5: return Opcodes::PUSH_rr(cpu, cpu.HL);
+        case 0xE6: return Opcodes::AND_u8(cpu);
+        case 0xE7: return Opcodes::RST_n(cpu, 4);
+        case 0xE8: return Opcodes::ADD_SP_s8(cpu);
+        case 0xE9: return Opcodes::JP_HL(cpu);
+        case 0xEA: return Opcodes::LD_ptr_u16_A(cpu);
+        case 0xEE: return Opcodes::XOR_u8(cpu);
+        case 0xEF: return Opcodes::RST_n(cpu, 5);
+        case 0xF0: return Opcodes::LDH_A_ptr_u8(cpu);
+        case 0xF1: return Opcodes::POP_AF(cpu);
+        case 0xF2: return Opcodes::LDH_A_ptr_C(cpu);
+        case 0xF3: return Opcodes::DI(cpu);
+        case 0xF5: return Opcodes::PUSH_AF(cpu);
+        case 0xF6: return Opcodes::OR_u8(cpu);
+        case 0xF7: return Opcodes::RST_n(cpu, 6);
+        case 0xF8: return Opcodes::LD_HL_SP_s8(cpu);
+        case 0xF9: return Opcodes::LD_SP_HL(cpu);
+        case 0xFA: return Opcodes::LD_A_ptr_u16(cpu);
+        case 0xFB: return Opcodes::EI(cpu);
+        case 0xFE: return Opcodes::CP_u8(cpu);
+        case 0xFF: return Opcodes::RST_n(cpu, 7);
+        default: return 0;
+    }
+}
+
+
+int main(int argc, char** argv) {
+    Hardware::CPU& cpu = benchmark_system.cpu;
+
+    auto run_switch = [&](int max_ticks) {
+        cpu.last_instruction_count = 1;
+        if (cpu.is_halted) return cpu.run_halted(max_ticks);
+        return execute_switch(cpu, cpu.fetch());
+    };
+
+    auto run_handler_table = [&](int max_ticks) {
+        cpu.last_instruction_count = 1;
+        if (cpu.is_halted) return cpu.run_halted(max_ticks);
+        return cpu.dispatch(Hardware::CPU::opcode_handlers[cpu.fetch()]);
+    };
+
+    #if defined(__GNUC__)
+        auto run_computed_goto = [&](int max_ticks) {
+            cpu.last_instruction_count = 1;
+            if (cpu.is_halted) return cpu.run_halted(max_ticks);
+            return cpu.execute_computed_goto(cpu.fetch());
+        };
+    #endif
+
+    cpu.is_block_cache_enabled = false;
+
+    for (std::string rom_path : get_rom_paths(argc, argv)) {
+        double switch_time = get_fastest_time([&]() {
+            benchmark_system.insert_rom(rom_path);
+            benchmark_system.run_frames(total_frames, run_switch);
+        });
+
+        long long total_instructions = benchmark_system.total_instructions;
+        std::cout << rom_path << " - " << total_instructions << " instructions over " << total_frames << " frames" << std::endl;
+        print_result("Switch (before)", total_instructions, "instructions", switch_time);
+
+        double handler_table_time = get_fastest_time([&]() {
+            benchmark_system.insert_rom(rom_path);
+            benchmark_system.run_frames(total_frames, run_handler_table);
+        });
+
+        if (benchmark_system.total_instructions != total_instructions) std::cerr << "Error: The dispatchers ran different instructions" << std::endl;
+        print_result("Handler table", total_instructions, "instructions", handler_table_time);
+        std::cout << "    " << std::left << std::setw(28) << "Handler table speedup" << std::right << std::setw(10) << switch_time / handler_table_time << " x" << std::endl;
+
+        #if defined(__GNUC__)
+            double computed_goto_time = get_fastest_time([&]() {
+                benchmark_system.insert_rom(rom_path);
+                benchmark_system.run_frames(total_frames, run_computed_goto);
+            });
+
+            if (benchmark_system.total_instructions != total_instructions) std::cerr << "Error: The dispatchers ran different instructions" << std::endl;
+            print_result("Computed goto", total_instructions, "instructions", computed_goto_time);
+        #endif
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,130 @@
+#include <iostream>
+#include <random>
+#include <vector>
+#include <array>
+#include "benchmark.hpp"
+#include "Opcodes/opcodes_helper.hpp"
+
+
+// Compares the lazily evaluated ALU flags against calculating all four flags after every instruction, as the ALU did before
+// A random mix of the register forms of ADD, ADC, SUB, SBC, AND, XOR, OR, CP, INC and DEC is run straight through the handlers
+// Programs usually test the flags of only a few of their ALU instructions, so the zero flag is read every few instructions
+
+
+static BenchmarkSystem& benchmark_system = BenchmarkSystem::get_instance();
+static const int total_repetitions = 4096;
+
+
+static U8& get_register(Hardware::CPU& cpu, int index) {
+    U8* registers[8] = {&cpu.B, &cpu.C, &cpu.D, &cpu.E, &cpu.H, &cpu.L, &cpu.A, &cpu.A}; // (HL) forms aren't part of the mix
+    return *registers[index];
+}
+
+
+// The previous handlers, which set each flag through CPU::set_flag as soon as the result was known
+template <int opcode>
+static int run_eager(Hardware::CPU& cpu) {
+    using Flag = Hardware::CPU::Flag;
+
+    if constexpr (opcode < 0x40) {
+        U8& u8 = get_register(cpu, opcode >> 3 & 7);
+        bool is_decrement = opcode & 1;
+        cpu.set_flag(Flag::HALF_CARRY, is_decrement ? Opcodes::check_half_borrow_u8(u8, 1, false) : Opcodes::check_half_carry_u8(u8, 1, false));
+        u8 = is_decrement ? u8 - 1 : u8 + 1;
+        cpu.set_flag(Flag::ZERO, u8 == 0);
+        cpu.set_flag(Flag::SUB, is_decrement);
+        return 4;
+    }
+
+    else {
+        U8 u8 = get_register(cpu, opcode & 7);
+        int operation = opcode >> 3 & 7;
+        bool carry = (operation == 1 || operation == 3) && cpu.get_flag(Flag::CARRY);
+        bool is_subtraction = operation == 2 || operation == 3 || operation == 7;
+        U8 result;
+
+        if (operation < 4 || operation == 7) {
+            cpu.set_flag(Flag::HALF_CARRY, is_subtraction ? Opcodes::check_half_borrow_u8(cpu.A, u8, carry) : Opcodes::check_half_carry_u8(cpu.A, u8, carry));
+            cpu.set_flag(Flag::CARRY, is_subtraction ? Opcodes::check_borrow_u8(cpu.A, u8, carry) : Opcodes::check_carry_u8(cpu.A, u8, carry));
+            result = is_subtraction ? cpu.A - u8 - carry : cpu.A + u8 + carry;
+        }
+
+        else {
+            result = operation == 4 ? cpu.A & u8 : operation == 5 ? cpu.A ^ u8 : cpu.A | u8;
+            cpu.set_flag(Flag::HALF_CARRY, operation == 4);
+            cpu.set_flag(Flag::CARRY, false);
+        }
+
+        cpu.set_flag(Flag::ZERO, result == 0);
+        cpu.set_flag(Flag::SUB, is_subtraction);
+        if (operation != 7) cpu.A = result;
+        return 4;
+    }
+}
+
+
+template <std::size_t... opcodes>
+static constexpr std::array<Hardware::CPU::OpcodeHandler, 256> generate_eager_handlers(std::index_sequence<opcodes...>) {
+    return {&run_eager<opcodes>...};
+}
+
+
+static const std::array<Hardware::CPU::OpcodeHandler, 256> eager_handlers = generate_eager_handlers(std::make_index_sequence<256>());
+
+
+static std::vector<U8> get_instruction_mix() {
+    std::vector<int> opcodes;
+
+    for (int r = 0; r < 8; r++) {
+        if (r == 6) continue;
+        opcodes.push_back(r << 3 | 0x04); // INC r
+        opcodes.push_back(r << 3 | 0x05); // DEC r
+        for (int operation = 0; operation < 8; operation++) opcodes.push_back(0x80 | operation << 3 | r);
+    }
+
+    std::mt19937 random(0x4C415A59);
+    std::vector<U8> mix(4096);
+    for (U8& opcode : mix) opcode = opcodes[random() % opcodes.size()];
+    return mix;
+}
+
+
+// Returns the final AF, so that the two sets of handlers can be checked against each other
+template <typename Handlers>
+static U16 run_mix(const Handlers& handlers, const std::vector<U8>& mix, int flags_read_interval) {
+    Hardware::CPU& cpu = benchmark_system.cpu;
+    cpu.write_AF(0x1230);
+    cpu.BC = 0x4567;
+    cpu.DE = 0x89AB;
+    cpu.HL = 0xCDEF;
+    int total_zero_flags = 0;
+
+    for (int i = 0; i < total_repetitions; i++) {
+        for (int j = 0; j < (int)mix.size(); j++) {
+            handlers[mix[j]](cpu);
+            if (j % flags_read_interval == 0) total_zero_flags += cpu.get_flag(Hardware::CPU::Flag::ZERO);
+        }
+    }
+
+    cpu.B += total_zero_flags; // Keeps the reads from being optimised away
+    return cpu.read_AF();
+}
+
+
+int main() {
+    std::vector<U8> mix = get_instruction_mix();
+    double total_instructions = (double)mix.size() * total_repetitions;
+
+    for (int flags_read_interval : {1, 4, 16}) {
+        U16 lazy_af = 0;
+        U16 eager_af = 0;
+        double lazy_time = get_fastest_time([&]() {lazy_af = run_mix(Hardware::CPU::opcode_handlers, mix, flags_read_interval);});
+        double eager_time = get_fastest_time([&]() {eager_af = run_mix(eager_handlers, mix, flags_read_interval);});
+        if (lazy_af != eager_af) std::cerr << "Error: The lazy and eager flags differ" << std::endl;
+        std::cout << "Zero flag read every " << flags_read_interval << " instructions" << std::endl;
+        print_result("Lazy flags", total_instructions, "instructions", lazy_time);
+        print_result("Eager flags", total_instructions, "instructions", eager_time);
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <vector>
+#include "benchmark.hpp"
+
+
+// Compares the MMU's page tables against sending every access through its handlers, as every access was before the page tables
+// Two memory bound loops are run on the CPU alone, from a ROM written out for the benchmark
+// With the page tables emptied, reads and writes fall through to handle_read_u8 and handle_write_u8, whose chains of range checks the page tables replaced
+
+
+static BenchmarkSystem& benchmark_system = BenchmarkSystem::get_instance();
+static const int total_steps = 1 << 22;
+
+
+struct Program {
+    std::string name;
+    U16 address;
+    std::vector<U8> code;
+};
+
+
+static const std::vector<Program> programs = {
+    {"Work RAM copy", 0x150, {
+        0x21, 0x00, 0xC0, // LD HL, 0xC000
+        0x11, 0x00, 0xC8, // LD DE, 0xC800
+        0x06, 0x00, // LD B, 0
+        0x2A, // LD A, (HL+)
+        0x12, // LD (DE), A
+        0x1C, // INC E
+        0xF0, 0x80, // LDH A, (0x80)
+        0x86, // ADD A, (HL)
+        0xE0, 0x81, // LDH (0x81), A
+        0xC5, // PUSH BC
+        0xC1, // POP BC
+        0x05, // DEC B
+        0x20, 0xF3, // JR NZ, -13
+        0xC3, 0x50, 0x01 // JP 0x0150
+    }},
+
+    {"ROM, video RAM and I/O reads", 0x200, {
+        0x21, 0x00, 0x40, // LD HL, 0x4000
+        0x01, 0x00, 0x80, // LD BC, 0x8000
+        0x16, 0x00, // LD D, 0
+        0x2A, // LD A, (HL+)
+        0x0A, // LD A, (BC)
+        0x0C, // INC C
+        0xF0, 0x44, // LDH A, (0x44)
+        0xF0, 0x80, // LDH A, (0x80)
+        0xE0, 0x82, // LDH (0x82), A
+        0xFA, 0x00, 0xC0, // LD A, (0xC000)
+        0xEA, 0x01, 0xC0, // LD (0xC001), A
+        0x15, // DEC D
+        0x20, 0xEE, // JR NZ, -18
+        0xC3, 0x00, 0x02 // JP 0x0200
+    }}
+};
+
+
+static std::string write_rom() {
+    std::vector<char> rom(0x8000, 0);
+    for (const Program& program : programs) std::copy(program.code.begin(), program.code.end(), rom.begin() + program.address);
+    std::string file_path = (std::filesystem::temp_directory_path() / "antboy_memory_benchmark.gb").string();
+    std::ofstream file(file_path, std::ios::binary);
+    file.write(rom.data(), rom.size());
+    return file_path;
+}
+
+
+// The ROM pages are marked as mapped so that the first ROM read doesn't map them again
+static void empty_page_tables() {
+    Hardware::MMU& mmu = benchmark_system.mmu;
+    mmu.read_pages.fill(nullptr);
+    mmu.write_pages.fill(nullptr);
+    mmu.are_rom_pages_mapped = true;
+    benchmark_system.cpu.fetch_window_length = 0;
+}
+
+
+static void run_program(const Program& program, bool is_page_table_enabled) {
+    Hardware::CPU& cpu = benchmark_system.cpu;
+    benchmark_system.mmu.map_pages();
+    if (!is_page_table_enabled) empty_page_tables();
+    cpu.program_counter = program.address;
+    benchmark_system.total_instructions = 0;
+
+    for (int i = 0; i < total_steps; i++) {
+        cpu.run(1 << 20);
+        benchmark_system.total_instructions += cpu.last_instruction_count;
+    }
+}
+
+
+int main() {
+    std::string file_path = write_rom();
+    benchmark_system.insert_rom(file_path);
+
+    for (const Program& program : programs) {
+        double page_table_time = get_fastest_time([&]() {run_program(program, true);});
+        long long total_instructions = benchmark_system.total_instructions;
+        double handler_time = get_fastest_time([&]() {run_program(program, false);});
+        std::cout << program.name << std::endl;
+        print_result("Page tables", total_instructions, "instructions", page_table_time);
+        print_result("Handlers only", benchmark_system.total_instructions, "instructions", handler_time);
+    }
+
+    benchmark_system.mmu.map_pages();
+    std::filesystem::remove(file_path);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,113 @@
+#include <iostream>
+#include <random>
+#include <vector>
+#include "benchmark.hpp"
+
+
+// Compares rendering the background a tile span at a time, from the decoded tile rows, against the per pixel renderer it replaced
+// The per pixel renderer read the tile index and the row of the tile through the MMU for every pixel, then picked out the pixel's two bits
+// Video RAM is filled with random tiles and tile maps, and every scanline of a frame is rendered with each renderer in turn
+
+
+static BenchmarkSystem& benchmark_system = BenchmarkSystem::get_instance();
+static const int total_frames = 2000;
+
+
+struct Scroll {
+    std::string name;
+    U8 scroll_x;
+    U8 scroll_y;
+};
+
+
+static const std::vector<Scroll> scrolls = {
+    {"Scrolled to a tile boundary", 0, 0},
+    {"Scrolled between tiles", 3, 21}
+};
+
+
+// Tile data is written through the MMU, so that the PPU marks each tile row to be decoded again
+static void fill_video_ram() {
+    std::mt19937 random(22);
+    for (int address = 0x8000; address < 0xA000; address++) benchmark_system.mmu.write_u8(address, random() & 0xFF);
+}
+
+
+static void render_background_per_pixel() {
+    Hardware::PPU& ppu = benchmark_system.ppu;
+    Hardware::MMU& mmu = benchmark_system.mmu;
+    U16 tile_map_offset = ppu.is_background_tile_map_1_selected ? 0x9C00 : 0x9800;
+    U8 background_y = ppu.scanline_y + ppu.scroll_y;
+    U8 tile_row = background_y >> 3;
+
+    for (U8 scanline_x = 0; scanline_x < 160; scanline_x++) {
+        U8 background_x = scanline_x + ppu.scroll_x;
+        U8 tile_col = background_x >> 3;
+        U8 tile_index = mmu.read_u8(tile_map_offset + tile_row * 32 + tile_col);
+        U16 tile_line = mmu.read_u16(ppu.get_tile_location(tile_index) + (background_y % 8) * 2);
+        U8 pixel_bit = 7 - (background_x % 8);
+        U8 color_id = (((tile_line >> 8) >> pixel_bit) & 1) << 1 | ((tile_line & 0xFF) >> pixel_bit & 1);
+        U8 color = (ppu.background_palette >> (color_id * 2)) & 3;
+        ppu.lcd.transfer_pixel(scanline_x, ppu.scanline_y, color);
+        ppu.current_scanline_buffer[scanline_x] = color_id;
+    }
+}
+
+
+template <typename RenderScanline>
+static void render_frames(RenderScanline render_scanline) {
+    Hardware::PPU& ppu = benchmark_system.ppu;
+    for (int frame = 0; frame < total_frames; frame++) {
+        for (ppu.scanline_y = 0; ppu.scanline_y < benchmark_system.lcd.height; ppu.scanline_y++) render_scanline();
+    }
+}
+
+
+// Both renderers have to draw the same frame, otherwise their times can't be compared
+static bool are_frames_equal() {
+    Hardware::PPU& ppu = benchmark_system.ppu;
+    Hardware::LCD& lcd = benchmark_system.lcd;
+    std::vector<U8> span_frame;
+    std::vector<U8> pixel_frame;
+
+    for (ppu.scanline_y = 0; ppu.scanline_y < lcd.height; ppu.scanline_y++) {
+        ppu.render_background();
+        span_frame.insert(span_frame.end(), lcd.get_scanline(ppu.scanline_y), lcd.get_scanline(ppu.scanline_y) + lcd.width);
+        render_background_per_pixel();
+        pixel_frame.insert(pixel_frame.end(), lcd.get_scanline(ppu.scanline_y), lcd.get_scanline(ppu.scanline_y) + lcd.width);
+    }
+
+    return span_frame == pixel_frame;
+}
+
+
+int main() {
+    Hardware::PPU& ppu = benchmark_system.ppu;
+    benchmark_system.reset();
+    fill_video_ram();
+    ppu.is_background_enabled = true;
+    ppu.background_palette = 0xE4;
+    double total_lines = (double)total_frames * benchmark_system.lcd.height;
+
+    for (const Scroll& scroll : scrolls) {
+        ppu.scroll_x = scroll.scroll_x;
+        ppu.scroll_y = scroll.scroll_y;
+
+        for (bool is_unsigned_tileset_selected : {true, false}) {
+            ppu.is_unsigned_background_tileset_selected = is_unsigned_tileset_selected;
+
+            if (!are_frames_equal()) {
+                std::cerr << "Error: The renderers drew different frames: " << scroll.name << std::endl;
+                return 1;
+            }
+
+            double span_time = get_fastest_time([&]() {render_frames([&]() {ppu.render_background();});});
+            double pixel_time = get_fastest_time([&]() {render_frames(render_background_per_pixel);});
+            std::cout << scroll.name << (is_unsigned_tileset_selected ? ", tiles from 0x8000" : ", tiles from 0x8800") << std::endl;
+            print_result("Decoded tile spans", total_lines, "lines", span_time);
+            print_result("Per pixel reads", total_lines, "lines", pixel_time);
+        }
+    }
+
+    return 0;
+}
\ No newline at end of file
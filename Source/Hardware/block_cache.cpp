@@ -0,0 +1,165 @@
+#include <algorithm>
+#include "block_cache.hpp"
+#include "cpu.hpp"
+#include "mmu.hpp"
+#include "cartridge.hpp"
+
+
+namespace Hardware {
+
+    // Caches runs of pre-decoded instructions (basic blocks) so they can be replayed without decoding each byte through the MMU again
+    // ROM blocks are kept in a separate set for each ROM bank, so a bank switch simply selects a different set
+    // RAM blocks are discarded whenever a page of RAM containing cached code is written to
+    BlockCache::BlockCache(MMU& _mmu) :
+        mmu(_mmu),
+        max_block_length(64) {
+        reset();
+    }
+
+
+    void BlockCache::reset() {
+        rom_block_sets.clear();
+        ram_block_set.clear();
+        for (auto& page_blocks : ram_page_blocks) page_blocks.clear();
+        is_ram_page_cached.fill(false);
+        bank_0_block_set = nullptr;
+        switchable_bank_block_set = nullptr;
+        active_block = nullptr;
+        active_instruction_index = 0;
+    }
+
+
+    void BlockCache::select_rom_block_sets() {
+        int bank_0 = mmu.cartridge.get_rom_bank(0);
+        int switchable_bank = mmu.cartridge.get_rom_bank(0x4000);
+        int total_banks = std::max(bank_0, switchable_bank) + 1;
+        if ((int)rom_block_sets.size() < total_banks) rom_block_sets.resize(total_banks);
+        bank_0_block_set = &rom_block_sets[bank_0];
+        switchable_bank_block_set = &rom_block_sets[switchable_bank];
+        active_block = nullptr; // The next instruction must be looked up again as it may now be in a different bank
+    }
+
+
+    const BlockCache::DecodedInstruction* BlockCache::get_instruction(U16 address) {
+
+        // Continues through the active block as long as execution hasn't branched away from it
+        if (active_block != nullptr && active_instruction_index < (int)active_block->instructions.size()) {
+            const DecodedInstruction& instruction = active_block->instructions[active_instruction_index];
+
+            if (instruction.address == address) {
+                active_instruction_index++;
+                return &instruction;
+            }
+        }
+
+        active_block = find_block(address);
+        if (active_block == nullptr) return nullptr;
+        active_instruction_index = 1;
+        return &active_block->instructions[0];
+    }
+
+
+    BlockCache::BasicBlock* BlockCache::find_block(U16 address) {
+        BlockSet* block_set;
+        int region_end; // Blocks never cross the end of a memory region, as the next region may be mapped to something else
+
+        if (address < 0x8000 && bank_0_block_set == nullptr) select_rom_block_sets();
+
+        if (address < 0x4000) {
+            block_set = bank_0_block_set;
+            region_end = 0x4000;
+        }
+
+        else if (address < 0x8000) {
+            block_set = switchable_bank_block_set;
+            region_end = 0x8000;
+        }
+
+        else if (address >= 0xC000 && address < 0xE000) {
+            block_set = &ram_block_set;
+            region_end = 0xE000;
+        }
+
+        else if (address >= 0xFF80 && address < 0xFFFF) {
+            block_set = &ram_block_set;
+            region_end = 0xFFFF;
+        }
+
+        else return nullptr; // Code in video RAM, cartridge RAM or I/O is rare, so it is interpreted instead
+
+        auto cached_block = block_set->find(address);
+        if (cached_block != block_set->end()) return &cached_block->second;
+
+        BasicBlock& block = (*block_set)[address];
+        decode_block(block, address, region_end);
+
+        if (block.instructions.empty()) {
+            block_set->erase(address);
+            return nullptr;
+        }
+
+        // Registers the block with each RAM page it covers so that writes to those pages invalidate it
+        if (block_set == &ram_block_set) {
+            for (int page = block.start_address >> 8; page <= (block.end_address - 1) >> 8; page++) {
+                ram_page_blocks[page].push_back(block.start_address);
+                is_ram_page_cached[page] = true;
+                mmu.map_work_ram_page(page);
+            }
+        }
+
+        return &block;
+    }
+
+
+    // Code is read through the MMU's handler, as decoding it isn't a data read which should trigger a read watchpoint
+    void BlockCache::decode_block(BasicBlock& block, U16 address, int region_end) {
+        block.start_address = address;
+        block.execution_count = 0;
+        block.is_native_compilation_attempted = false;
+        block.native_code = nullptr;
+        block.idle_loop_state = UNCHECKED;
+
+        while ((int)block.instructions.size() < max_block_length) {
+            U8 opcode = mmu.handle_read_u8(address);
+            int length = instruction_lengths[opcode];
+            if (address + length > region_end) break;
+
+            // Prefixed opcodes are resolved to their handler here, so replaying them skips the second dispatch
+            DecodedInstruction instruction;
+            instruction.address = address;
+            instruction.opcode_length = opcode == 0xCB ? 2 : 1;
+            instruction.handler = opcode == 0xCB ? CPU::opcode_handlers[0x100 | mmu.handle_read_u8(address + 1)] : CPU::opcode_handlers[opcode];
+            instruction.fused_handler = nullptr;
+            for (int i = 0; i < length; i++) block.bytes.push_back(mmu.handle_read_u8(address + i));
+            block.instructions.push_back(instruction);
+            address += length;
+            if (does_end_block(opcode)) break;
+        }
+
+        block.end_address = address;
+
+        // Marks the first instruction of each pair which has a fused handler
+        for (int i = 0; i + 1 < (int)block.instructions.size(); i++) {
+            int first = get_opcode(block, i);
+            int second = get_opcode(block, i + 1);
+            block.instructions[i].fused_handler = CPU::find_superinstruction(first, second);
+        }
+    }
+
+
+    // Prefixed opcodes are returned as 0x1XX
+    int BlockCache::get_opcode(BasicBlock& block, int instruction_index) {
+        int offset = block.instructions[instruction_index].address - block.start_address;
+        if (block.bytes[offset] == 0xCB) return 0x100 | block.bytes[offset + 1];
+        return block.bytes[offset];
+    }
+
+
+    void BlockCache::invalidate_ram_page(U8 page) {
+        for (U16 start_address : ram_page_blocks[page]) ram_block_set.erase(start_address);
+        ram_page_blocks[page].clear();
+        is_ram_page_cached[page] = false;
+        mmu.map_work_ram_page(page);
+        active_block = nullptr; // The active block may have just been erased, or even overwritten by itself
+    }
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+#pragma once
+
+
+#include <cstdint>
+#include <vector>
+#include <array>
+#include <unordered_map>
+
+
+typedef unsigned char U8;
+typedef unsigned short U16;
+
+
+namespace Hardware {
+    class CPU;
+    class MMU;
+
+
+    class BlockCache {
+    public:
+        typedef int (*OpcodeHandler)(CPU& cpu);
+        typedef void (*NativeCode)(U8* registers);
+        enum IdleLoopState {UNCHECKED, IDLE_LOOP, NOT_IDLE_LOOP};
+
+        struct DecodedInstruction {
+            OpcodeHandler handler;
+            U16 address;
+            U8 opcode_length;
+            OpcodeHandler fused_handler;
+        };
+
+        struct BasicBlock {
+            U16 start_address;
+            U16 end_address;
+            std::vector<U8> bytes;
+            std::vector<DecodedInstruction> instructions;
+            int execution_count;
+            bool is_native_compilation_attempted;
+            NativeCode native_code;
+            int native_instructions;
+            int native_ticks;
+            U16 native_end_address;
+            IdleLoopState idle_loop_state;
+            U16 idle_loop_address;
+            int idle_loop_ticks;
+        };
+
+        typedef std::unordered_map<U16, BasicBlock> BlockSet;
+        MMU& mmu;
+        int max_block_length;
+        std::vector<BlockSet> rom_block_sets;
+        BlockSet* bank_0_block_set;
+        BlockSet* switchable_bank_block_set;
+        BlockSet ram_block_set;
+        std::array<std::vector<U16>, 256> ram_page_blocks;
+        std::array<bool, 256> is_ram_page_cached;
+        BasicBlock* active_block;
+        int active_instruction_index;
+
+        BlockCache(MMU& _mmu);
+        void reset();
+        void select_rom_block_sets();
+        const DecodedInstruction* get_instruction(U16 address);
+        BasicBlock* find_block(U16 address);
+        void decode_block(BasicBlock& block, U16 address, int region_end);
+        void invalidate_ram_page(U8 page);
+        int get_opcode(BasicBlock& block, int instruction_index);
+
+
+        // The number of bytes each opcode occupies, including its immediate operands
+        // These match how far each opcode handler advances the program counter, so unused opcodes are a single byte
+        static constexpr U8 instruction_lengths[256] = {
+            1, 3, 1, 1, 1, 1, 2, 1, 3, 1, 1, 1, 1, 1, 2, 1,
+            1, 3, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1,
+            2, 3, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1,
+            2, 3, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1,
+            1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+            1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+            1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+            1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+            1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+            1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+            1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+            1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+            1, 1, 3, 3, 3, 1, 2, 1, 1, 1, 3, 2, 3, 3, 2, 1,
+            1, 1, 3, 1, 3, 1, 2, 1, 1, 1, 3, 1, 3, 1, 2, 1,
+            2, 1, 1, 1, 1, 1, 2, 1, 2, 1, 3, 1, 1, 1, 2, 1,
+            2, 1, 1, 1, 1, 1, 2, 1, 2, 1, 3, 1, 1, 1, 2, 1
+        };
+
+
+        // Whether an opcode can move the program counter somewhere other than the next instruction (jumps, calls, returns, restarts, HALT and STOP)
+        static constexpr bool does_end_block(U8 opcode) {
+            switch (opcode) {
+                case 0x10: case 0x18: case 0x20: case 0x28: case 0x30: case 0x38: case 0x76:
+                case 0xC0: case 0xC2: case 0xC3: case 0xC4: case 0xC7: case 0xC8: case 0xC9: case 0xCA: case 0xCC: case 0xCD: case 0xCF:
+                case 0xD0: case 0xD2: case 0xD4: case 0xD7: case 0xD8: case 0xD9: case 0xDA: case 0xDC: case 0xDF:
+                case 0xE7: case 0xE9: case 0xEF: case 0xF7: case 0xFF: return true;
+                default: return false;
+            }
+        }
+    };
+}
\ No newline at end of file
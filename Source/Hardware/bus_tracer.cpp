@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include "bus_tracer.hpp"
+#include "mmu.hpp"
+
+
+namespace Hardware {
+
+    // Records every access made to the bus by the CPU, the PPU and OAM DMA into a compact binary trace file
+    // Records are placed into a fixed size ring buffer by the emulation thread and streamed to the file by a background thread
+    // While recording, the MMU's page tables and the CPU's fetch window and block cache are bypassed so that every access goes through a hook
+    BusTracer::BusTracer(MMU& _mmu) :
+        mmu(_mmu),
+        is_enabled(false),
+        is_recording(false),
+        cycle(0),
+        buffer(std::make_unique<Record[]>(buffer_size)),
+        write_index(0),
+        read_index(0),
+        is_writer_running(false) {
+    }
+
+
+    BusTracer::~BusTracer() {
+        stop();
+    }
+
+
+    void BusTracer::start(std::string trace_path) {
+        stop();
+        file.open(trace_path, std::ios::binary);
+
+        if (!file) {
+            std::cerr << "Error: Unable to open the bus trace file " << trace_path << std::endl;
+            return;
+        }
+
+        file.write(magic, 4);
+        file.write((const char*)&version, 4);
+        cycle = 0;
+        write_index = 0;
+        read_index = 0;
+        is_recording = true;
+        is_writer_running = true;
+        writer_thread = std::thread(&BusTracer::write_records, this);
+        if (!mmu.is_dma_active) mmu.map_pages(); // A timed OAM DMA maps the pages itself once it completes
+    }
+
+
+    // Waits for the background thread to write out the rest of the buffer before closing the file
+    void BusTracer::stop() {
+        if (!is_recording) return;
+        is_recording = false;
+        is_writer_running = false;
+        writer_thread.join();
+        file.close();
+        if (!mmu.is_dma_active) mmu.map_pages();
+    }
+
+
+    // Waits for the background thread when the buffer is full rather than dropping records, so the trace is always complete
+    void BusTracer::record(U16 address, U8 u8, bool is_write, Source source) {
+        size_t index = write_index.load(std::memory_order_relaxed);
+        while (index - read_index.load(std::memory_order_acquire) == buffer_size) std::this_thread::yield();
+        buffer[index & (buffer_size - 1)] = {(uint32_t)cycle, address, u8, (U8)(is_write | source << 1)};
+        write_index.store(index + 1, std::memory_order_release);
+    }
+
+
+    // Runs on the background thread, writing out each contiguous run of records in the buffer with a single write
+    void BusTracer::write_records() {
+        while (true) {
+            bool is_stopping = !is_writer_running.load(std::memory_order_acquire); // Checked first, so the records written before stopping are always seen
+            size_t start_index = read_index.load(std::memory_order_relaxed);
+            size_t end_index = write_index.load(std::memory_order_acquire);
+
+            if (start_index == end_index) {
+                if (is_stopping) return;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+
+            size_t offset = start_index & (buffer_size - 1);
+            size_t total_records = std::min(end_index - start_index, buffer_size - offset);
+            file.write((const char*)&buffer[offset], total_records * sizeof(Record));
+            read_index.store(start_index + total_records, std::memory_order_release);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+
+
+#include <cstdint>
+#include <string>
+#include <fstream>
+#include <memory>
+#include <atomic>
+#include <thread>
+
+
+typedef unsigned char U8;
+typedef unsigned short U16;
+
+
+namespace Hardware {
+    class MMU;
+
+
+    class BusTracer {
+    public:
+        enum Source {FROM_CPU, FROM_PPU, FROM_DMA};
+
+        // One bus access as stored in the trace file, after an 8 byte header of "ABTR" and the format version
+        // The cycle is the low 32 bits of the ticks since the trace started, so readers must unwrap it
+        // The flags hold whether the access was a write in bit 0, and its source in bits 1-2
+        struct Record {
+            uint32_t cycle;
+            U16 address;
+            U8 u8;
+            U8 flags;
+        };
+
+        static constexpr char magic[4] = {'A', 'B', 'T', 'R'};
+        static constexpr uint32_t version = 1;
+        static constexpr size_t buffer_size = 1 << 16;
+        MMU& mmu;
+        bool is_enabled;
+        bool is_recording;
+        unsigned long long cycle;
+        std::unique_ptr<Record[]> buffer;
+        std::atomic<size_t> write_index;
+        std::atomic<size_t> read_index;
+        std::atomic<bool> is_writer_running;
+        std::thread writer_thread;
+        std::ofstream file;
+
+        BusTracer(MMU& _mmu);
+        ~BusTracer();
+        void start(std::string trace_path);
+        void stop();
+        void record(U16 address, U8 u8, bool is_write, Source source);
+        void write_records();
+    };
+}
\ No newline at end of file
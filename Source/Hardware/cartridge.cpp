@@ -1,83 +1,128 @@
 #include <cstring>
+#include <cstdint>
+#include <ctime>
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <filesystem>
 #include "cartridge.hpp"
+#include "timer.hpp"
 #include "../Utilities/misc.hpp"
 
 
 namespace Hardware {
 
     // Houses the game's ROM, RAM, MBC and sometimes the battery
-    Cartridge::Cartridge() {reset();}
+    Cartridge::Cartridge(Timer& _timer) :
+        timer(_timer),
+        save_delay_ticks(4194304), // One second of emulated time
+        is_save_thread_running(false) {
+        reset();
+    }
 
 
+    // The Gameboy saves the RAM itself before its timer is destroyed, as the MBC3's clock is worked out from the timer
     Cartridge::~Cartridge() {save_ram();}
 
 
     void Cartridge::reset() {
+        save_ram(); // Makes sure the previous game is saved before it is removed
         does_contain_battery = false;
-        is_saved = false;
-        rom = std::make_unique<U8[]> (2097152); // Initialised size of 2 MB so that the ROM can be loaded in regardless of size
-        ram = std::make_unique<U8[]> (131072); // Same for RAM with 128 KB
+        does_contain_clock = false;
+        is_ram_dirty = false; // Only a cartridge with a battery has its RAM marked dirty, once start_saving has been called
+        last_ram_write_ticks = 0;
+        rom = nullptr; // The ROM is mapped and the RAM is allocated to fit once a ROM has been inserted
+        ram = nullptr;
+        rom_size = 0;
+        ram_size = 0;
+        rom_bank_0_base = nullptr; // The banks are selected once a ROM has been inserted
+        switchable_rom_bank_base = nullptr;
+        ram_bank_base = nullptr;
+        ram_address_mask = 0;
+        ram_upper_bits = 0;
+        mbc = MBC();
     }
 
 
-    U8 Cartridge::read_rom(U16 address) {
-        U8 rom_bank = 0;
+    // The MBCs are a closed set held by value, so calls into them are resolved statically rather than through virtual functions
+    // Every MBC shares the banking state of the MBC base class
+    MBC& Cartridge::get_mbc() {return std::visit([](MBC& base) -> MBC& {return base;}, mbc);}
+
+
+    int Cartridge::get_rom_bank(U16 address) {return std::visit([address](auto& mbc) {return mbc.get_rom_bank(address);}, mbc);}
+
 
-        // MBC bank zero access
-        if (address < 0x4000) {
-            mbc->modify_rom_bank(address, rom_bank);
-            return rom[0x4000 * rom_bank + address];
+    // Works out where each bank currently lives, so that reads and writes don't have to consult the MBC
+    // Must be called whenever the MBC's banking state may have changed
+    void Cartridge::select_banks() {
+        rom_bank_0_base = rom->data + 0x4000 * get_rom_bank(0);
+        switchable_rom_bank_base = rom->data + 0x4000 * get_rom_bank(0x4000);
+        ram_bank_base = nullptr; // RAM which is disabled or missing reads as 0xFF and ignores writes
+        ram_upper_bits = 0;
+        MBC& state = get_mbc();
+        if (!state.is_ram_enabled || ram_size == 0) return;
+
+        if (state.type == 2) {
+            ram_bank_base = ram.get();
+            ram_address_mask = 0x1FF; // Address should only contain 9 bits
+            ram_upper_bits = 0xF0; // MBC2 RAM is only 4 bits wide, so the upper 4 bits always read as 1
+            return;
         }
 
-        // MBC swappable bank access. The operation (rom bank mod total banks) is performed because
-        // bank numbers are wrapped if they exceed the total number of banks
-        rom_bank = mbc->rom_bank % mbc->total_rom_banks;
-        mbc->modify_rom_bank(address, rom_bank);
-        return rom[0x4000 * rom_bank + address - 0x4000];
+        if (state.type == 3 && state.ram_bank >= 8) return; // The MBC3's clock registers are accessed through the MBC instead
+        int ram_bank = state.type == 1 && state.is_rom_bank_mode ? 0 : state.ram_bank; // MBC1 can only access RAM bank 0 in rom bank mode
+        ram_bank_base = &ram[0x2000 * (ram_bank % std::max(1, ram_size / 0x2000))]; // Bank numbers wrap around the RAM which is present
+        ram_address_mask = ram_size <= 8192 ? ram_size - 1 : 0x1FFF; // RAM address for RAM size less than or equal to 8KB are wrapped
     }
 
 
-    U8 Cartridge::read_ram(U16 address) {
-        if (!mbc->is_ram_enabled) return 0xFF;
+    bool Cartridge::is_clock_selected() {
+        MBC& state = get_mbc();
+        return does_contain_clock && state.is_ram_enabled && state.ram_bank >= 8 && state.ram_bank <= 0xC;
+    }
 
-        if (mbc->type == 1) {
-            U8 ram_bank = mbc->is_rom_bank_mode ? 0 : mbc->ram_bank;
-            if (ram_size == 0) return 0xFF;
-            if (ram_size <= 8192) return ram[(address - 0xA000) % ram_size]; // RAM address for RAM size less than or equal to 8KB are wrapped
-            else return ram[0x2000 * ram_bank + address - 0xA000];
-        }
 
-        if (mbc->type == 2) return ram[address & 0x1FF] | 0xF0; // Address should only contain 9 bits and should return the value with upper 4 bits set to 1
-        return 0xFF;
+    U8 Cartridge::read_rom(U16 address) {return address < 0x4000 ? rom_bank_0_base[address] : switchable_rom_bank_base[address - 0x4000];}
+
+
+    // Writes to ROM are intercepted by the MBC to switch banks
+    // Returns false if the cartridge has no MBC, in which case the write has no effect at all
+    bool Cartridge::write_rom(U16 address, U8 u8) {
+        if (std::holds_alternative<MBC>(mbc)) return false;
+        std::visit([address, u8](auto& mbc) {mbc.write(address, u8);}, mbc);
+        select_banks();
+        return true;
     }
 
 
-    void Cartridge::write_ram(U16 address, U8 u8) {
-        if (!mbc->is_ram_enabled) return;
+    U8 Cartridge::read_ram(U16 address) {
+        if (ram_bank_base == nullptr) return is_clock_selected() ? std::get<MBC3>(mbc).read_clock() : 0xFF;
+        return ram_bank_base[address & ram_address_mask] | ram_upper_bits;
+    }
 
-        if (mbc->type == 1) {
-            U8 ram_bank = mbc->is_rom_bank_mode ? 0 : mbc->ram_bank; // Can only read from RAM bank 0 in rom bank mode
 
-            if (ram_size == 0) return;
-            if (ram_size <= 8192) ram[(address - 0xA000) % ram_size] = u8;
-            else ram[0x2000 * ram_bank + address - 0xA000] = u8;
+    void Cartridge::write_ram(U16 address, U8 u8) {
+        if (ram_bank_base == nullptr) {
+            if (!is_clock_selected()) return;
+            std::get<MBC3>(mbc).write_clock(u8);
+            is_ram_dirty = does_contain_battery; // The clock is saved along with the RAM
+            last_ram_write_ticks = timer.total_ticks;
+            return;
         }
 
-        else if (mbc->type == 2) ram[address & 0x1FF] = u8 | 0xF0;
+        U8* byte = &ram_bank_base[address & ram_address_mask];
+        *byte = u8 | ram_upper_bits;
+        if (!does_contain_battery) return;
+        dirty_ram_pages[(byte - ram.get()) / save_page_size] = true;
+        is_ram_dirty = true;
+        last_ram_write_ticks = timer.total_ticks;
     }
 
 
     void Cartridge::insert(std::string _file_path) {
         file_path = _file_path;
-        std::ifstream file(file_path, std::ios::binary);
-        file.seekg(0, std::ios::end);
-        std::streampos size = file.tellg();
-        file.seekg(0, std::ios::beg);
-        file.read((char*)rom.get(), size);
-        file.close();
+        rom = RomImage::open(file_path);
+        rom_size = rom->size;
         configure();
     }
 
@@ -85,30 +130,29 @@ namespace Hardware {
     void Cartridge::configure() {
 
         // Cartridge type
-        switch (rom[0x147]) {
-            case 0: mbc = std::make_shared<MBC>(0); break;
-            case 1: mbc = std::make_shared<MBC1>(); break;
-            case 2: mbc = std::make_shared<MBC1>(); break;
-            case 3: mbc = std::make_shared<MBC1>(); does_contain_battery = true; break;
-            case 5: mbc = std::make_shared<MBC2>(); break;
-            case 6: mbc = std::make_shared<MBC2>(); does_contain_battery = true; break;
-        }
-
-        switch (rom[0x148]) {
-            case 0: rom_size = 32768; break;
-            case 1: rom_size = 65536; break;
-            case 2: rom_size = 131072; break;
-            case 3: rom_size = 262144; break;
-            case 4: rom_size = 524288; break;
-            case 5: rom_size = 1048576; break;
-            case 6: rom_size = 2097152; break;
-            case 7: rom_size = 4194304; break;
-            case 8: rom_size = 8388608; break;
+        switch (rom->data[0x147]) {
+            case 0: mbc = MBC(); break;
+            case 1: mbc = MBC1(); break;
+            case 2: mbc = MBC1(); break;
+            case 3: mbc = MBC1(); does_contain_battery = true; break;
+            case 5: mbc = MBC2(); break;
+            case 6: mbc = MBC2(); does_contain_battery = true; break;
+            case 0xF: mbc = MBC3(&timer); does_contain_battery = true; does_contain_clock = true; break;
+            case 0x10: mbc = MBC3(&timer); does_contain_battery = true; does_contain_clock = true; break;
+            case 0x11: mbc = MBC3(&timer); break;
+            case 0x12: mbc = MBC3(&timer); break;
+            case 0x13: mbc = MBC3(&timer); does_contain_battery = true; break;
+            case 0x19: mbc = MBC5(); break;
+            case 0x1A: mbc = MBC5(); break;
+            case 0x1B: mbc = MBC5(); does_contain_battery = true; break;
+            case 0x1C: mbc = MBC5(); break;
+            case 0x1D: mbc = MBC5(); break;
+            case 0x1E: mbc = MBC5(); does_contain_battery = true; break;
         }
 
-        mbc->total_rom_banks = 1 << (rom[0x148] + 1);
+        get_mbc().total_rom_banks = rom_size / 0x4000;
 
-        switch (rom[0x149]) {
+        switch (rom->data[0x149]) {
             case 1: ram_size = 2048; break;
             case 2: ram_size = 8192; break;
             case 3: ram_size = 32768; break;
@@ -117,35 +161,153 @@ namespace Hardware {
             default: ram_size = 0; break;
         }
 
+        if (get_mbc().type == 2) ram_size = 512; // MBC2 has 512 half bytes of RAM built in, which isn't reported by the header
+        if (ram_size > 0) ram = std::make_unique<U8[]>(ram_size);
+        save_file_path = file_path.substr(0, file_path.length() - 3) + ".sav";
         load_ram();
+        start_saving();
+        select_banks();
 
         std::cout << "Cartridge name: " << Utilities::get_file_name_from_path(file_path) << std::endl;
-        std::cout << "MBC: " << mbc->type << std::endl;
+        std::cout << "MBC: " << get_mbc().type << std::endl;
         std::cout << "ROM size: " << rom_size << " Bytes" << std::endl;
         std::cout << "RAM size: " << ram_size << " Bytes" << std::endl;
-        std::cout << "Total ROM banks: " << mbc->total_rom_banks << std::endl << std::endl;
+        std::cout << "Total ROM banks: " << get_mbc().total_rom_banks << std::endl << std::endl;
+    }
+
+
+    // Battery backed RAM is written back to the save file by a background thread, so the emulation never waits on the disk
+    // Writes mark the 512 byte pages of RAM they touch as dirty, and once the RAM has been left alone for a moment the dirty pages are copied into the save buffer
+    // The save thread writes the save buffer to a temporary file which then replaces the save file, so a crash part way through can't leave a broken save
+    void Cartridge::start_saving() {
+        if (!does_contain_battery) return;
+        save_buffer.assign(ram_size + (does_contain_clock ? 48 : 0), 0);
+        if (ram_size > 0) std::memcpy(save_buffer.data(), ram.get(), ram_size);
+        dirty_ram_pages.assign((ram_size + save_page_size - 1) / save_page_size, false);
+        is_ram_dirty = false;
+        last_ram_write_ticks = timer.total_ticks;
+        is_save_pending = false;
+        is_save_thread_running = true;
+        save_thread = std::thread(&Cartridge::write_saves, this);
+    }
+
+
+    // Called once per frame
+    void Cartridge::update_save() {
+        if (!is_save_thread_running || !is_ram_dirty || timer.total_ticks - last_ram_write_ticks < (unsigned long long)save_delay_ticks) return;
+        queue_save(false);
+    }
+
+
+    // Copies the dirty pages into the save buffer and wakes the save thread
+    // Without can_wait this gives up if the save thread is taking its copy of the save buffer, leaving the pages dirty to be tried again next frame
+    bool Cartridge::queue_save(bool can_wait) {
+        std::unique_lock<std::mutex> lock(save_mutex, std::defer_lock);
+        if (can_wait) lock.lock();
+        else if (!lock.try_lock()) return false;
+
+        for (int page = 0; page < (int)dirty_ram_pages.size(); page++) {
+            if (!dirty_ram_pages[page]) continue;
+            int offset = page * save_page_size;
+            std::memcpy(&save_buffer[offset], &ram[offset], std::min(save_page_size, ram_size - offset));
+            dirty_ram_pages[page] = false;
+        }
+
+        if (does_contain_clock) save_clock(&save_buffer[ram_size]);
+        is_ram_dirty = false;
+        is_save_pending = true;
+        save_condition.notify_one();
+        return true;
     }
 
 
+    // Runs on the save thread, only holding the lock while it copies the save buffer
+    void Cartridge::write_saves() {
+        std::vector<U8> file_data;
+        std::string temporary_file_path = save_file_path + ".tmp";
+        std::unique_lock<std::mutex> lock(save_mutex);
+
+        while (true) {
+            save_condition.wait(lock, [this] {return is_save_pending || !is_save_thread_running;});
+            if (!is_save_pending) return;
+            file_data = save_buffer;
+            is_save_pending = false;
+            lock.unlock();
+
+            std::ofstream file(temporary_file_path, std::ios::binary);
+            file.write((char*)file_data.data(), file_data.size());
+            file.close();
+            std::error_code error;
+            if (!file.fail()) std::filesystem::rename(temporary_file_path, save_file_path, error);
+            if (file.fail() || error) std::cerr << "Error: Unable to write the save file " << save_file_path << std::endl;
+            lock.lock();
+        }
+    }
+
+
+    // Queues anything left unsaved and waits for the save thread to write it out, which is only done when the cartridge is removed
+    // Games with a clock are always saved, as the clock has moved on since the last save
     void Cartridge::save_ram() {
-        if (!does_contain_battery || is_saved) return;
-        std::string save_file_path = file_path.substr(0, file_path.length() - 3) + ".sav";
-        std::ofstream file(save_file_path, std::ios::binary);
-        file.write((char*)ram.get(), ram_size);
-        file.close();
-        is_saved = true;
+        if (!is_save_thread_running) return;
+        if (is_ram_dirty || does_contain_clock) queue_save(true);
+
+        {
+            std::lock_guard<std::mutex> lock(save_mutex);
+            is_save_thread_running = false;
+        }
+
+        save_condition.notify_one();
+        save_thread.join();
     }
 
 
     void Cartridge::load_ram() {
         if (!does_contain_battery) return;
-        std::string save_file_path = file_path.substr(0, file_path.length() - 3) + ".sav";
         std::ifstream file(save_file_path, std::ios::binary);
         if (!file.is_open()) return;
         file.seekg(0, std::ios::end);
         std::streampos size = file.tellg();
         file.seekg(0, std::ios::beg);
         file.read((char*)ram.get(), ram_size);
+        if (does_contain_clock) load_clock(file);
         file.close();
     }
+
+
+    // The clock is stored after the RAM in the layout shared by most emulators
+    // This is the current then latched clock registers as 32-bit values, followed by the 64-bit UNIX time of the save
+    void Cartridge::save_clock(U8* clock_data) {
+        MBC3& mbc3 = std::get<MBC3>(mbc);
+        mbc3.update_clock();
+        std::array<U8, 5> clock_registers = mbc3.get_clock_registers();
+        uint32_t saved_clock_registers[10];
+        int64_t save_time = std::time(nullptr);
+
+        for (int i = 0; i < 5; i++) {
+            saved_clock_registers[i] = clock_registers[i];
+            saved_clock_registers[i + 5] = mbc3.latched_clock_registers[i];
+        }
+
+        std::memcpy(clock_data, saved_clock_registers, 40);
+        std::memcpy(clock_data + 40, &save_time, 8);
+    }
+
+
+    // The cartridge's battery keeps the clock running while the emulator is closed, so the real time since the save is added on
+    void Cartridge::load_clock(std::ifstream& file) {
+        uint32_t saved_clock_registers[10];
+        int64_t save_time;
+        if (!file.read((char*)saved_clock_registers, 40) || !file.read((char*)&save_time, 8)) return;
+        MBC3& mbc3 = std::get<MBC3>(mbc);
+        std::array<U8, 5> clock_registers;
+
+        for (int i = 0; i < 5; i++) {
+            clock_registers[i] = saved_clock_registers[i];
+            mbc3.latched_clock_registers[i] = saved_clock_registers[i + 5];
+        }
+
+        mbc3.set_clock_registers(clock_registers);
+        if (!mbc3.is_clock_halted) mbc3.clock_seconds += std::max<int64_t>(0, std::time(nullptr) - save_time);
+        mbc3.update_clock(); // Wraps the day counter
+    }
 }
@@ -5,7 +5,13 @@
 #include <string>
 #include <unordered_map>
 #include <memory>
+#include <variant>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "mbc.hpp"
+#include "rom_image.hpp"
 
 
 typedef unsigned char U8;
@@ -13,26 +19,58 @@ typedef unsigned short U16;
 
 
 namespace Hardware {
+    class Timer;
+
+
     class Cartridge {
     public:
-        std::unique_ptr<U8[]> rom;
+        Timer& timer;
+        std::shared_ptr<RomImage> rom;
         std::unique_ptr<U8[]> ram;
         int rom_size;
         int ram_size;
         bool does_contain_battery;
-        bool is_saved;
-        std::shared_ptr<MBC> mbc;
+        bool does_contain_clock;
+        std::variant<MBC, MBC1, MBC2, MBC3, MBC5> mbc;
         std::string file_path;
+        const U8* rom_bank_0_base;
+        const U8* switchable_rom_bank_base;
+        U8* ram_bank_base;
+        int ram_address_mask;
+        U8 ram_upper_bits;
+        static constexpr int save_page_size = 512;
+        const int save_delay_ticks;
+        std::string save_file_path;
+        std::vector<bool> dirty_ram_pages;
+        bool is_ram_dirty;
+        unsigned long long last_ram_write_ticks;
+        std::vector<U8> save_buffer;
+        bool is_save_pending;
+        bool is_save_thread_running;
+        std::thread save_thread;
+        std::mutex save_mutex;
+        std::condition_variable save_condition;
 
-        Cartridge();
+        Cartridge(Timer& _timer);
         ~Cartridge();
         void reset();
+        MBC& get_mbc();
+        int get_rom_bank(U16 address);
+        void select_banks();
+        bool is_clock_selected();
         U8 read_rom(U16 address);
+        bool write_rom(U16 address, U8 u8);
         U8 read_ram(U16 address);
         void write_ram(U16 address, U8 u8);
         void insert(std::string _file_path);
         void configure();
+        void start_saving();
+        void update_save();
+        bool queue_save(bool can_wait);
+        void write_saves();
         void save_ram();
         void load_ram();
+        void save_clock(U8* clock_data);
+        void load_clock(std::ifstream& file);
     };
 }
@@ -1,14 +1,20 @@
 #include <cstdint>
+#include <algorithm>
+#include <array>
+#include <utility>
 #include <fstream>
 #include <sstream>
 #include "cpu.hpp"
 #include "mmu.hpp"
+#include "ppu.hpp"
+#include "timer.hpp"
 #include "../Opcodes/alu_opcodes.hpp"
 #include "../Opcodes/load_opcodes.hpp"
 #include "../Opcodes/func_opcodes.hpp"
 #include "../Opcodes/jump_opcodes.hpp"
 #include "../Opcodes/misc_opcodes.hpp"
 #include "../Opcodes/bitmanip_opcodes.hpp"
+#include "../Opcodes/opcodes_helper.hpp"
 #include "../Utilities/misc.hpp"
 #include <fstream>
 #include <iomanip>
@@ -21,13 +27,21 @@ namespace Hardware {
     // All other components are clocked by the ticks taken by the CPU's last instruction
     CPU::CPU(MMU& _mmu) :
         mmu(_mmu),
-        clock_speed(4194304) {
+        clock_speed(4194304),
+        block_cache(_mmu),
+        is_block_cache_enabled(true),
+        jit(*this),
+        is_jit_enabled(false),
+        idle_loop_detector(*this),
+        opcode_profiler(_mmu),
+        are_superinstructions_enabled(true) {
         reset();
     };
 
 
     void CPU::reset() {
         ticks = 0;
+        last_instruction_count = 1;
         is_interrupt_master_enabled = false;
         stack_pointer = 0xFFFE;
         is_halted = false;
@@ -35,43 +49,151 @@ namespace Hardware {
         interrupt_flag = 0;
         is_interrupt_master_enabled = false;
         can_enable_interrupts = false;
-        write_combined_register(AF, 0x01B0);
-        write_combined_register(BC, 0x0013);
-        write_combined_register(DE, 0x00D8);
-        write_combined_register(HL, 0x014D);
+        fetch_window = nullptr;
+        fetch_window_start = 0;
+        fetch_window_length = 0;
+        block_cache.reset();
+        jit.reset();
+        idle_loop_detector.reset();
+        opcode_profiler.reset();
+        lazy_flag_operation = NO_OPERATION;
+        write_AF(0x01B0);
+        BC = 0x0013;
+        DE = 0x00D8;
+        HL = 0x014D;
     }
 
 
-    int CPU::run() {
-        if (is_halted) return 4;
+    // Components are clocked by the ticks of the CPU's last instruction
+    // This iterates until the ticks threshold is reached for the frame, or until a watchpoint is hit
+    // When a watchpoint is hit, the rest of the frame is left in ticks so it can be run once the watchpoint is resumed
+    bool CPU::run_frame(int ticks_per_frame) {
+        while (ticks < ticks_per_frame) {
+            int last_instruction_ticks = run(ticks_per_frame - ticks);
+            if (mmu.watchpoints.is_hit && last_instruction_ticks == 0) return false; // Stopped before an execution breakpoint
+            ticks += last_instruction_ticks;
+            if (mmu.bus_tracer.is_recording) mmu.bus_tracer.cycle += last_instruction_ticks;
+            mmu.timer.run(last_instruction_ticks);
+            if (mmu.timer.total_ticks >= mmu.ppu.next_event_tick) mmu.ppu.run(last_instruction_count); // The PPU is only run once its next mode switch is due
+            mmu.run_dma(last_instruction_ticks);
+            handle_interrupts();
+            if (mmu.watchpoints.is_hit) return false; // Read and write watchpoints stop once the instruction accessing memory has completed
+        }
+
+        ticks -= ticks_per_frame;
+        return true;
+    }
+
+
+    // Idle loops and halt mode may skip ahead by several instructions, but never by more than max_skipped_ticks
+    int CPU::run(int max_skipped_ticks) {
+        last_instruction_count = 1;
+        if (is_halted) return run_halted(max_skipped_ticks);
+
+        // Stops before the instruction at an execution breakpoint, leaving Gameboy::emulate to return at this instruction boundary
+        if (mmu.watchpoints.watched_pages[Watchpoints::EXECUTE][program_counter >> 8] > 0 && mmu.watchpoints.check_execution(program_counter)) {
+            last_instruction_count = 0;
+            return 0;
+        }
+
+        if (opcode_profiler.is_enabled) opcode_profiler.record(program_counter);
+
+        // Replays the next instruction from the block cache when possible, skipping the fetch and decode
+        // The bootstrap is interpreted as it is only executed once and overlays the start of ROM bank 0
+        // Timed OAM DMA blocks the CPU from reading most of memory, so the short wait for it to complete is interpreted too
+        // Instructions are interpreted while tracing the bus, as the cache replays them without fetching their bytes
+        if (is_block_cache_enabled && !mmu.is_bootstrap_enabled && !mmu.is_dma_active && !mmu.bus_tracer.is_recording) {
+            const BlockCache::DecodedInstruction* instruction = block_cache.get_instruction(program_counter);
+
+            if (instruction != nullptr) {
+
+                // Instructions are only run one at a time while debugging, so that none of them can run past a watchpoint
+                bool can_run_ahead = mmu.watchpoints.total_watchpoints == 0;
+
+                // Skips the repeated iterations of loops which are polling memory
+                if (idle_loop_detector.is_enabled && can_run_ahead && block_cache.active_instruction_index == 1) {
+                    int skipped_ticks = idle_loop_detector.run(*block_cache.active_block, max_skipped_ticks);
+                    if (skipped_ticks > 0) return skipped_ticks;
+                }
+
+                // Runs the start of hot blocks as native code when no interrupt could be serviced part way through them
+                // Blocks which would run past max_skipped_ticks are interpreted, so that the frame's ticks aren't overshot
+                if (is_jit_enabled && can_run_ahead && block_cache.active_instruction_index == 1) {
+                    int native_ticks = jit.run(*block_cache.active_block, get_ticks_before_interrupt(max_skipped_ticks));
+
+                    if (native_ticks > 0) {
+                        last_instruction_count = block_cache.active_block->native_instructions;
+                        return native_ticks;
+                    }
+                }
+
+                // Runs a pair of instructions through a single fused handler when no interrupt could be serviced between them
+                // The first instruction mustn't be able to reach max_skipped_ticks or the next interrupt by itself (the longest instruction takes 24 ticks)
+                // Superinstructions are skipped while profiling so that each instruction of the pair is recorded
+                bool can_run_superinstruction = are_superinstructions_enabled && can_run_ahead && !opcode_profiler.is_enabled && max_skipped_ticks > 24;
+
+                if (instruction->fused_handler != nullptr && can_run_superinstruction && get_ticks_before_interrupt(max_skipped_ticks) >= 24) {
+                    program_counter += instruction->opcode_length;
+                    block_cache.active_instruction_index++;
+                    last_instruction_count = 2;
+                    return dispatch(instruction->fused_handler);
+                }
+
+                program_counter += instruction->opcode_length;
+                return dispatch(instruction->handler);
+            }
+        }
+
         U8 opcode = fetch();
         return execute(opcode);
     }
 
 
 
-    U16 CPU::read_combined_register(CombinedRegister combined_register) {
-        switch (combined_register) {
-            case AF: return (U16)A << 8 | F;
-            case BC: return (U16)B << 8 | C;
-            case DE: return (U16)D << 8 | E;
-            case HL: return (U16)H << 8 | L;
-            default: return 0;
-        }
+    // Skips halt mode straight to the next point where the PPU or timer could raise an interrupt, or max_ticks if sooner
+    // The skipped ticks are rounded up to the 4 tick steps which halt mode would otherwise take one at a time
+    // The joypad is only updated between frames, so limiting the skip to the end of the frame covers its interrupt
+    int CPU::run_halted(int max_ticks) {
+        int ticks_until_interrupt = get_ticks_until_interrupt(max_ticks);
+        int skipped_ticks = std::max(4, (ticks_until_interrupt + 3) / 4 * 4);
+        last_instruction_count = skipped_ticks / 4;
+        return skipped_ticks;
     }
 
 
-    void CPU::write_combined_register(CombinedRegister combined_register, U16 u16) {
-        switch (combined_register) {
-            case AF: A = u16 >> 8; F = u16 & 0xF0; break;
-            case BC: B = u16 >> 8; C = u16 & 0xFF; break;
-            case DE: D = u16 >> 8; E = u16 & 0xFF; break;
-            case HL: H = u16 >> 8; L = u16 & 0xFF; break;
-        }
+    // Interrupts are only raised when the PPU switches modes, when the timer counter overflows, or by the joypad between frames
+    int CPU::get_ticks_until_interrupt(int max_ticks) {
+        return std::min({mmu.ppu.get_ticks_until_next_event(), mmu.timer.get_ticks_until_counter_overflow(), max_ticks});
+    }
+
+
+    // The most ticks which can be run as a single step without an interrupt being serviced part way through, up to max_ticks
+    // An interrupt is serviced after the instruction which raises it, so the step has to finish before the PPU or timer's next event
+    // An interrupt already pending is serviced after the instruction following EI, so nothing can be run ahead of it
+    int CPU::get_ticks_before_interrupt(int max_ticks) {
+        if (!can_service_interrupts()) return max_ticks;
+        if ((interrupt_flag & interrupt_enabled) != 0) return 0;
+        int ticks_until_interrupt = std::min(mmu.ppu.get_ticks_until_next_event(), mmu.timer.get_ticks_until_counter_overflow());
+        return std::min(max_ticks, ticks_until_interrupt - 1);
+    }
+
+
+    U16 CPU::read_AF() {
+        evaluate_lazy_flags();
+        return AF;
+    }
+
+
+    // The low nibble of F isn't wired to anything, so it always reads back as 0
+    void CPU::write_AF(U16 u16) {
+        AF = u16 & 0xFFF0;
+        lazy_flag_operation = NO_OPERATION;
     }
 
 
     void CPU::set_flag(Flag flag, bool state) {
+        evaluate_lazy_flags();
+
         switch (flag) {
             case ZERO: Utilities::set_bit_u8(F, 7, state); break;
             case SUB: Utilities::set_bit_u8(F, 6, state); break;
@@ -82,6 +204,8 @@ namespace Hardware {
 
 
     bool CPU::get_flag(Flag flag) {
+        evaluate_lazy_flags();
+
         switch (flag) {
             case ZERO: return Utilities::get_bit_u8(F, 7);
             case SUB: return Utilities::get_bit_u8(F, 6);
@@ -92,6 +216,88 @@ namespace Hardware {
     }
 
 
+    // Records the operands of an 8-bit ALU operation so that its flags are only calculated once they are read
+    // For ADC and SBC the carry is the carry in, while INC and DEC keep it as the resulting carry flag
+    void CPU::set_lazy_flags(FlagOperation operation, U8 a, U8 b, bool carry) {
+        lazy_flag_operation = operation;
+        lazy_flag_a = a;
+        lazy_flag_b = b;
+        lazy_flag_carry = carry;
+    }
+
+
+    // Calculates the flags of the last recorded ALU operation into the F register
+    void CPU::evaluate_lazy_flags() {
+        if (lazy_flag_operation == NO_OPERATION) return;
+        int a = lazy_flag_a;
+        int b = lazy_flag_b;
+        int carry = lazy_flag_carry;
+        bool is_zero = false;
+        bool is_sub = false;
+        bool is_half_carry = false;
+        bool is_carry = false;
+
+        switch (lazy_flag_operation) {
+            case ADD_OPERATION:
+            case ADC_OPERATION:
+                if (lazy_flag_operation == ADD_OPERATION) carry = 0;
+                is_zero = (U8)(a + b + carry) == 0;
+                is_half_carry = Opcodes::check_half_carry_u8(a, b, carry);
+                is_carry = Opcodes::check_carry_u8(a, b, carry);
+                break;
+
+            case SUB_OPERATION:
+            case SBC_OPERATION:
+                if (lazy_flag_operation == SUB_OPERATION) carry = 0;
+                is_zero = (U8)(a - b - carry) == 0;
+                is_sub = true;
+                is_half_carry = Opcodes::check_half_borrow_u8(a, b, carry);
+                is_carry = Opcodes::check_borrow_u8(a, b, carry);
+                break;
+
+            case INC_OPERATION:
+                is_zero = (U8)(a + 1) == 0;
+                is_half_carry = Opcodes::check_half_carry_u8(a, 1, false);
+                is_carry = carry;
+                break;
+
+            case DEC_OPERATION:
+                is_zero = (U8)(a - 1) == 0;
+                is_sub = true;
+                is_half_carry = Opcodes::check_half_borrow_u8(a, 1, false);
+                is_carry = carry;
+                break;
+
+            case AND_OPERATION:
+                is_zero = a == 0;
+                is_half_carry = true;
+                break;
+
+            case LOGICAL_OPERATION: is_zero = a == 0; break;
+            default: break;
+        }
+
+        F = is_zero << 7 | is_sub << 6 | is_half_carry << 5 | is_carry << 4;
+        lazy_flag_operation = NO_OPERATION;
+    }
+
+
+    // Calculates only the carry flag of the last recorded ALU operation, leaving the operation pending
+    // INC and DEC keep the carry flag, so a run of them can carry it forward without ever writing F
+    bool CPU::get_lazy_carry() {
+        switch (lazy_flag_operation) {
+            case NO_OPERATION: return Utilities::get_bit_u8(F, 4);
+            case ADD_OPERATION: return Opcodes::check_carry_u8(lazy_flag_a, lazy_flag_b, false);
+            case ADC_OPERATION: return Opcodes::check_carry_u8(lazy_flag_a, lazy_flag_b, lazy_flag_carry);
+            case SUB_OPERATION: return Opcodes::check_borrow_u8(lazy_flag_a, lazy_flag_b, false);
+            case SBC_OPERATION: return Opcodes::check_borrow_u8(lazy_flag_a, lazy_flag_b, lazy_flag_carry);
+            case INC_OPERATION:
+            case DEC_OPERATION: return lazy_flag_carry;
+            default: return false;
+        }
+    }
+
+
     void CPU::push_onto_stack(U16 u16) {
         stack_pointer -= 2;
         mmu.write_u16(stack_pointer, u16);
@@ -120,7 +326,12 @@ namespace Hardware {
     }
 
 
+    // Whether an interrupt could be serviced if one were triggered before the next instruction
+    bool CPU::can_service_interrupts() {return (is_interrupt_master_enabled || can_enable_interrupts) && interrupt_enabled != 0;}
+
+
     void CPU::call_interrupt_service_routine(U8 interrupt_bit) {
+        idle_loop_detector.candidate_block = nullptr; // The interrupted loop iteration doesn't run to completion
         is_interrupt_master_enabled = false;
         push_onto_stack(program_counter);
         set_interrupt(interrupt_bit, false);
@@ -134,534 +345,406 @@ namespace Hardware {
     }
 
 
+    // The instruction stream is fetched through a direct pointer (the fetch window) to the memory holding the current page of code
+    // This covers every page the MMU maps for reading, as well as high RAM which shares its page with the I/O registers
+    // The window is only moved once the program counter leaves it, and is closed by the MMU whenever the pages are remapped
+    void CPU::map_fetch_window() {
+        U8 page = program_counter >> 8;
+        fetch_window = mmu.read_pages[page];
+        fetch_window_start = page << 8;
+        fetch_window_length = fetch_window == nullptr ? 0 : 256;
+
+        if (program_counter >= 0xFF80 && program_counter < 0xFFFF && !mmu.bus_tracer.is_recording) {
+            fetch_window = mmu.high_ram.get();
+            fetch_window_start = 0xFF80;
+            fetch_window_length = 127;
+        }
+    }
+
+
+    // Code outside of the fetch window's memory (cartridge RAM, OAM, I/O or a watched page) is read through the MMU's handler instead
+    // Fetches aren't data reads, so they skip the read watchpoints
     U8 CPU::fetch() {
-        U8 opcode = mmu.read_u8(program_counter);
+        if ((U16)(program_counter - fetch_window_start) >= fetch_window_length) map_fetch_window();
+        U8 u8;
+
+        if (fetch_window_length > 0) u8 = fetch_window[program_counter - fetch_window_start];
+        else {
+            u8 = mmu.handle_read_u8(program_counter);
+            if (mmu.bus_tracer.is_recording) mmu.bus_tracer.record(program_counter, u8, false, BusTracer::FROM_CPU);
+        }
+
         program_counter++;
-        return opcode;
+        return u8;
+    }
+
+
+    // Both bytes are read with a single load when they are within the fetch window
+    U16 CPU::fetch_u16() {
+        int offset = (U16)(program_counter - fetch_window_start);
+
+        if (offset + 1 < fetch_window_length) {
+            const U8* bytes = fetch_window + offset;
+            program_counter += 2;
+            return (U16)bytes[1] << 8 | bytes[0]; // Gameboy uses little endian
+        }
+
+        U8 low_byte = fetch();
+        U8 high_byte = fetch();
+        return (U16)high_byte << 8 | low_byte;
     }
 
 
     int CPU::execute(U8 opcode) {
 
+        // Decoding through the handler table rather than a switch, so every opcode costs a single indexed call
+        // The 0xCB prefix has its own handler which fetches a second time and dispatches into the prefixed half of the table
+        // Builds with ANTBOY_COMPUTED_GOTO defined jump through a table of labels instead (see execute_computed_goto)
+        #if defined(ANTBOY_COMPUTED_GOTO) && defined(__GNUC__)
+            return execute_computed_goto(opcode);
+        #else
+            return dispatch(opcode_handlers[opcode]);
+        #endif
+    }
+
+
+    int CPU::dispatch(OpcodeHandler handler) {
+
         // Enable interrupts after delay
         if (can_enable_interrupts) {
             is_interrupt_master_enabled = true;
             can_enable_interrupts = false;
         }
 
-        // Decoding prefixed opcodes
-        if (opcode == 0xCB) {
-
-            // Fetch a second time to get the prefixed opcode
-            switch (fetch()) {
-                case 0x00: return Opcodes::RLC_r(*this, B);
-                case 0x01: return Opcodes::RLC_r(*this, C);
-                case 0x02: return Opcodes::RLC_r(*this, D);
-                case 0x03: return Opcodes::RLC_r(*this, E);
-                case 0x04: return Opcodes::RLC_r(*this, H);
-                case 0x05: return Opcodes::RLC_r(*this, L);
-                case 0x06: return Opcodes::RLC_ptr_HL(*this);
-                case 0x07: return Opcodes::RLC_r(*this, A);
-                case 0x08: return Opcodes::RRC_r(*this, B);
-                case 0x09: return Opcodes::RRC_r(*this, C);
-                case 0x0A: return Opcodes::RRC_r(*this, D);
-                case 0x0B: return Opcodes::RRC_r(*this, E);
-                case 0x0C: return Opcodes::RRC_r(*this, H);
-                case 0x0D: return Opcodes::RRC_r(*this, L);
-                case 0x0E: return Opcodes::RRC_ptr_HL(*this);
-                case 0x0F: return Opcodes::RRC_r(*this, A);
-                case 0x10: return Opcodes::RL_r(*this, B);
-                case 0x11: return Opcodes::RL_r(*this, C);
-                case 0x12: return Opcodes::RL_r(*this, D);
-                case 0x13: return Opcodes::RL_r(*this, E);
-                case 0x14: return Opcodes::RL_r(*this, H);
-                case 0x15: return Opcodes::RL_r(*this, L);
-                case 0x16: return Opcodes::RL_ptr_HL(*this);
-                case 0x17: return Opcodes::RL_r(*this, A);
-                case 0x18: return Opcodes::RR_r(*this, B);
-                case 0x19: return Opcodes::RR_r(*this, C);
-                case 0x1A: return Opcodes::RR_r(*this, D);
-                case 0x1B: return Opcodes::RR_r(*this, E);
-                case 0x1C: return Opcodes::RR_r(*this, H);
-                case 0x1D: return Opcodes::RR_r(*this, L);
-                case 0x1E: return Opcodes::RR_ptr_HL(*this);
-                case 0x1F: return Opcodes::RR_r(*this, A);
-                case 0x20: return Opcodes::SLA_r(*this, B);
-                case 0x21: return Opcodes::SLA_r(*this, C);
-                case 0x22: return Opcodes::SLA_r(*this, D);
-                case 0x23: return Opcodes::SLA_r(*this, E);
-                case 0x24: return Opcodes::SLA_r(*this, H);
-                case 0x25: return Opcodes::SLA_r(*this, L);
-                case 0x26: return Opcodes::SLA_ptr_HL(*this);
-                case 0x27: return Opcodes::SLA_r(*this, A);
-                case 0x28: return Opcodes::SRA_r(*this, B);
-                case 0x29: return Opcodes::SRA_r(*this, C);
-                case 0x2A: return Opcodes::SRA_r(*this, D);
-                case 0x2B: return Opcodes::SRA_r(*this, E);
-                case 0x2C: return Opcodes::SRA_r(*this, H);
-                case 0x2D: return Opcodes::SRA_r(*this, L);
-                case 0x2E: return Opcodes::SRA_ptr_HL(*this);
-                case 0x2F: return Opcodes::SRA_r(*this, A);
-                case 0x30: return Opcodes::SWAP_r(*this, B);
-                case 0x31: return Opcodes::SWAP_r(*this, C);
-                case 0x32: return Opcodes::SWAP_r(*this, D);
-                case 0x33: return Opcodes::SWAP_r(*this, E);
-                case 0x34: return Opcodes::SWAP_r(*this, H);
-                case 0x35: return Opcodes::SWAP_r(*this, L);
-                case 0x36: return Opcodes::SWAP_ptr_HL(*this);
-                case 0x37: return Opcodes::SWAP_r(*this, A);
-                case 0x38: return Opcodes::SRL_r(*this, B);
-                case 0x39: return Opcodes::SRL_r(*this, C);
-                case 0x3A: return Opcodes::SRL_r(*this, D);
-                case 0x3B: return Opcodes::SRL_r(*this, E);
-                case 0x3C: return Opcodes::SRL_r(*this, H);
-                case 0x3D: return Opcodes::SRL_r(*this, L);
-                case 0x3E: return Opcodes::SRL_ptr_HL(*this);
-                case 0x3F: return Opcodes::SRL_r(*this, A);
-                case 0x40: return Opcodes::BIT_b_r(*this, 0, B);
-                case 0x41: return Opcodes::BIT_b_r(*this, 0, C);
-                case 0x42: return Opcodes::BIT_b_r(*this, 0, D);
-                case 0x43: return Opcodes::BIT_b_r(*this, 0, E);
-                case 0x44: return Opcodes::BIT_b_r(*this, 0, H);
-                case 0x45: return Opcodes::BIT_b_r(*this, 0, L);
-                case 0x46: return Opcodes::BIT_b_ptr_HL(*this, 0);
-                case 0x47: return Opcodes::BIT_b_r(*this, 0, A);
-                case 0x48: return Opcodes::BIT_b_r(*this, 1, B);
-                case 0x49: return Opcodes::BIT_b_r(*this, 1, C);
-                case 0x4A: return Opcodes::BIT_b_r(*this, 1, D);
-                case 0x4B: return Opcodes::BIT_b_r(*this, 1, E);
-                case 0x4C: return Opcodes::BIT_b_r(*this, 1, H);
-                case 0x4D: return Opcodes::BIT_b_r(*this, 1, L);
-                case 0x4E: return Opcodes::BIT_b_ptr_HL(*this, 1);
-                case 0x4F: return Opcodes::BIT_b_r(*this, 1, A);
-                case 0x50: return Opcodes::BIT_b_r(*this, 2, B);
-                case 0x51: return Opcodes::BIT_b_r(*this, 2, C);
-                case 0x52: return Opcodes::BIT_b_r(*this, 2, D);
-                case 0x53: return Opcodes::BIT_b_r(*this, 2, E);
-                case 0x54: return Opcodes::BIT_b_r(*this, 2, H);
-                case 0x55: return Opcodes::BIT_b_r(*this, 2, L);
-                case 0x56: return Opcodes::BIT_b_ptr_HL(*this, 2);
-                case 0x57: return Opcodes::BIT_b_r(*this, 2, A);
-                case 0x58: return Opcodes::BIT_b_r(*this, 3, B);
-                case 0x59: return Opcodes::BIT_b_r(*this, 3, C);
-                case 0x5A: return Opcodes::BIT_b_r(*this, 3, D);
-                case 0x5B: return Opcodes::BIT_b_r(*this, 3, E);
-                case 0x5C: return Opcodes::BIT_b_r(*this, 3, H);
-                case 0x5D: return Opcodes::BIT_b_r(*this, 3, L);
-                case 0x5E: return Opcodes::BIT_b_ptr_HL(*this, 3);
-                case 0x5F: return Opcodes::BIT_b_r(*this, 3, A);
-                case 0x60: return Opcodes::BIT_b_r(*this, 4, B);
-                case 0x61: return Opcodes::BIT_b_r(*this, 4, C);
-                case 0x62: return Opcodes::BIT_b_r(*this, 4, D);
-                case 0x63: return Opcodes::BIT_b_r(*this, 4, E);
-                case 0x64: return Opcodes::BIT_b_r(*this, 4, H);
-                case 0x65: return Opcodes::BIT_b_r(*this, 4, L);
-                case 0x66: return Opcodes::BIT_b_ptr_HL(*this, 4);
-                case 0x67: return Opcodes::BIT_b_r(*this, 4, A);
-                case 0x68: return Opcodes::BIT_b_r(*this, 5, B);
-                case 0x69: return Opcodes::BIT_b_r(*this, 5, C);
-                case 0x6A: return Opcodes::BIT_b_r(*this, 5, D);
-                case 0x6B: return Opcodes::BIT_b_r(*this, 5, E);
-                case 0x6C: return Opcodes::BIT_b_r(*this, 5, H);
-                case 0x6D: return Opcodes::BIT_b_r(*this, 5, L);
-                case 0x6E: return Opcodes::BIT_b_ptr_HL(*this, 5);
-                case 0x6F: return Opcodes::BIT_b_r(*this, 5, A);
-                case 0x70: return Opcodes::BIT_b_r(*this, 6, B);
-                case 0x71: return Opcodes::BIT_b_r(*this, 6, C);
-                case 0x72: return Opcodes::BIT_b_r(*this, 6, D);
-                case 0x73: return Opcodes::BIT_b_r(*this, 6, E);
-                case 0x74: return Opcodes::BIT_b_r(*this, 6, H);
-                case 0x75: return Opcodes::BIT_b_r(*this, 6, L);
-                case 0x76: return Opcodes::BIT_b_ptr_HL(*this, 6);
-                case 0x77: return Opcodes::BIT_b_r(*this, 6, A);
-                case 0x78: return Opcodes::BIT_b_r(*this, 7, B);
-                case 0x79: return Opcodes::BIT_b_r(*this, 7, C);
-                case 0x7A: return Opcodes::BIT_b_r(*this, 7, D);
-                case 0x7B: return Opcodes::BIT_b_r(*this, 7, E);
-                case 0x7C: return Opcodes::BIT_b_r(*this, 7, H);
-                case 0x7D: return Opcodes::BIT_b_r(*this, 7, L);
-                case 0x7E: return Opcodes::BIT_b_ptr_HL(*this, 7);
-                case 0x7F: return Opcodes::BIT_b_r(*this, 7, A);
-                case 0x80: return Opcodes::RES_b_r(*this, 0, B);
-                case 0x81: return Opcodes::RES_b_r(*this, 0, C);
-                case 0x82: return Opcodes::RES_b_r(*this, 0, D);
-                case 0x83: return Opcodes::RES_b_r(*this, 0, E);
-                case 0x84: return Opcodes::RES_b_r(*this, 0, H);
-                case 0x85: return Opcodes::RES_b_r(*this, 0, L);
-                case 0x86: return Opcodes::RES_b_ptr_HL(*this, 0);
-                case 0x87: return Opcodes::RES_b_r(*this, 0, A);
-                case 0x88: return Opcodes::RES_b_r(*this, 1, B);
-                case 0x89: return Opcodes::RES_b_r(*this, 1, C);
-                case 0x8A: return Opcodes::RES_b_r(*this, 1, D);
-                case 0x8B: return Opcodes::RES_b_r(*this, 1, E);
-                case 0x8C: return Opcodes::RES_b_r(*this, 1, H);
-                case 0x8D: return Opcodes::RES_b_r(*this, 1, L);
-                case 0x8E: return Opcodes::RES_b_ptr_HL(*this, 1);
-                case 0x8F: return Opcodes::RES_b_r(*this, 1, A);
-                case 0x90: return Opcodes::RES_b_r(*this, 2, B);
-                case 0x91: return Opcodes::RES_b_r(*this, 2, C);
-                case 0x92: return Opcodes::RES_b_r(*this, 2, D);
-                case 0x93: return Opcodes::RES_b_r(*this, 2, E);
-                case 0x94: return Opcodes::RES_b_r(*this, 2, H);
-                case 0x95: return Opcodes::RES_b_r(*this, 2, L);
-                case 0x96: return Opcodes::RES_b_ptr_HL(*this, 2);
-                case 0x97: return Opcodes::RES_b_r(*this, 2, A);
-                case 0x98: return Opcodes::RES_b_r(*this, 3, B);
-                case 0x99: return Opcodes::RES_b_r(*this, 3, C);
-                case 0x9A: return Opcodes::RES_b_r(*this, 3, D);
-                case 0x9B: return Opcodes::RES_b_r(*this, 3, E);
-                case 0x9C: return Opcodes::RES_b_r(*this, 3, H);
-                case 0x9D: return Opcodes::RES_b_r(*this, 3, L);
-                case 0x9E: return Opcodes::RES_b_ptr_HL(*this, 3);
-                case 0x9F: return Opcodes::RES_b_r(*this, 3, A);
-                case 0xA0: return Opcodes::RES_b_r(*this, 4, B);
-                case 0xA1: return Opcodes::RES_b_r(*this, 4, C);
-                case 0xA2: return Opcodes::RES_b_r(*this, 4, D);
-                case 0xA3: return Opcodes::RES_b_r(*this, 4, E);
-                case 0xA4: return Opcodes::RES_b_r(*this, 4, H);
-                case 0xA5: return Opcodes::RES_b_r(*this, 4, L);
-                case 0xA6: return Opcodes::RES_b_ptr_HL(*this, 4);
-                case 0xA7: return Opcodes::RES_b_r(*this, 4, A);
-                case 0xA8: return Opcodes::RES_b_r(*this, 5, B);
-                case 0xA9: return Opcodes::RES_b_r(*this, 5, C);
-                case 0xAA: return Opcodes::RES_b_r(*this, 5, D);
-                case 0xAB: return Opcodes::RES_b_r(*this, 5, E);
-                case 0xAC: return Opcodes::RES_b_r(*this, 5, H);
-                case 0xAD: return Opcodes::RES_b_r(*this, 5, L);
-                case 0xAE: return Opcodes::RES_b_ptr_HL(*this, 5);
-                case 0xAF: return Opcodes::RES_b_r(*this, 5, A);
-                case 0xB0: return Opcodes::RES_b_r(*this, 6, B);
-                case 0xB1: return Opcodes::RES_b_r(*this, 6, C);
-                case 0xB2: return Opcodes::RES_b_r(*this, 6, D);
-                case 0xB3: return Opcodes::RES_b_r(*this, 6, E);
-                case 0xB4: return Opcodes::RES_b_r(*this, 6, H);
-                case 0xB5: return Opcodes::RES_b_r(*this, 6, L);
-                case 0xB6: return Opcodes::RES_b_ptr_HL(*this, 6);
-                case 0xB7: return Opcodes::RES_b_r(*this, 6, A);
-                case 0xB8: return Opcodes::RES_b_r(*this, 7, B);
-                case 0xB9: return Opcodes::RES_b_r(*this, 7, C);
-                case 0xBA: return Opcodes::RES_b_r(*this, 7, D);
-                case 0xBB: return Opcodes::RES_b_r(*this, 7, E);
-                case 0xBC: return Opcodes::RES_b_r(*this, 7, H);
-                case 0xBD: return Opcodes::RES_b_r(*this, 7, L);
-                case 0xBE: return Opcodes::RES_b_ptr_HL(*this, 7);
-                case 0xBF: return Opcodes::RES_b_r(*this, 7, A);
-                case 0xC0: return Opcodes::SET_b_r(*this, 0, B);
-                case 0xC1: return Opcodes::SET_b_r(*this, 0, C);
-                case 0xC2: return Opcodes::SET_b_r(*this, 0, D);
-                case 0xC3: return Opcodes::SET_b_r(*this, 0, E);
-                case 0xC4: return Opcodes::SET_b_r(*this, 0, H);
-                case 0xC5: return Opcodes::SET_b_r(*this, 0, L);
-                case 0xC6: return Opcodes::SET_b_ptr_HL(*this, 0);
-                case 0xC7: return Opcodes::SET_b_r(*this, 0, A);
-                case 0xC8: return Opcodes::SET_b_r(*this, 1, B);
-                case 0xC9: return Opcodes::SET_b_r(*this, 1, C);
-                case 0xCA: return Opcodes::SET_b_r(*this, 1, D);
-                case 0xCB: return Opcodes::SET_b_r(*this, 1, E);
-                case 0xCC: return Opcodes::SET_b_r(*this, 1, H);
-                case 0xCD: return Opcodes::SET_b_r(*this, 1, L);
-                case 0xCE: return Opcodes::SET_b_ptr_HL(*this, 1);
-                case 0xCF: return Opcodes::SET_b_r(*this, 1, A);
-                case 0xD0: return Opcodes::SET_b_r(*this, 2, B);
-                case 0xD1: return Opcodes::SET_b_r(*this, 2, C);
-                case 0xD2: return Opcodes::SET_b_r(*this, 2, D);
-                case 0xD3: return Opcodes::SET_b_r(*this, 2, E);
-                case 0xD4: return Opcodes::SET_b_r(*this, 2, H);
-                case 0xD5: return Opcodes::SET_b_r(*this, 2, L);
-                case 0xD6: return Opcodes::SET_b_ptr_HL(*this, 2);
-                case 0xD7: return Opcodes::SET_b_r(*this, 2, A);
-                case 0xD8: return Opcodes::SET_b_r(*this, 3, B);
-                case 0xD9: return Opcodes::SET_b_r(*this, 3, C);
-                case 0xDA: return Opcodes::SET_b_r(*this, 3, D);
-                case 0xDB: return Opcodes::SET_b_r(*this, 3, E);
-                case 0xDC: return Opcodes::SET_b_r(*this, 3, H);
-                case 0xDD: return Opcodes::SET_b_r(*this, 3, L);
-                case 0xDE: return Opcodes::SET_b_ptr_HL(*this, 3);
-                case 0xDF: return Opcodes::SET_b_r(*this, 3, A);
-                case 0xE0: return Opcodes::SET_b_r(*this, 4, B);
-                case 0xE1: return Opcodes::SET_b_r(*this, 4, C);
-                case 0xE2: return Opcodes::SET_b_r(*this, 4, D);
-                case 0xE3: return Opcodes::SET_b_r(*this, 4, E);
-                case 0xE4: return Opcodes::SET_b_r(*this, 4, H);
-                case 0xE5: return Opcodes::SET_b_r(*this, 4, L);
-                case 0xE6: return Opcodes::SET_b_ptr_HL(*this, 4);
-                case 0xE7: return Opcodes::SET_b_r(*this, 4, A);
-                case 0xE8: return Opcodes::SET_b_r(*this, 5, B);
-                case 0xE9: return Opcodes::SET_b_r(*this, 5, C);
-                case 0xEA: return Opcodes::SET_b_r(*this, 5, D);
-                case 0xEB: return Opcodes::SET_b_r(*this, 5, E);
-                case 0xEC: return Opcodes::SET_b_r(*this, 5, H);
-                case 0xED: return Opcodes::SET_b_r(*this, 5, L);
-                case 0xEE: return Opcodes::SET_b_ptr_HL(*this, 5);
-                case 0xEF: return Opcodes::SET_b_r(*this, 5, A);
-                case 0xF0: return Opcodes::SET_b_r(*this, 6, B);
-                case 0xF1: return Opcodes::SET_b_r(*this, 6, C);
-                case 0xF2: return Opcodes::SET_b_r(*this, 6, D);
-                case 0xF3: return Opcodes::SET_b_r(*this, 6, E);
-                case 0xF4: return Opcodes::SET_b_r(*this, 6, H);
-                case 0xF5: return Opcodes::SET_b_r(*this, 6, L);
-                case 0xF6: return Opcodes::SET_b_ptr_HL(*this, 6);
-                case 0xF7: return Opcodes::SET_b_r(*this, 6, A);
-                case 0xF8: return Opcodes::SET_b_r(*this, 7, B);
-                case 0xF9: return Opcodes::SET_b_r(*this, 7, C);
-                case 0xFA: return Opcodes::SET_b_r(*this, 7, D);
-                case 0xFB: return Opcodes::SET_b_r(*this, 7, E);
-                case 0xFC: return Opcodes::SET_b_r(*this, 7, H);
-                case 0xFD: return Opcodes::SET_b_r(*this, 7, L);
-                case 0xFE: return Opcodes::SET_b_ptr_HL(*this, 7);
-                case 0xFF: return Opcodes::SET_b_r(*this, 7, A);
-                default: return 0;
+        return handler(*this);
+    }
+
+
+    // Prefixed opcodes, which are offset by 0x100 within the handler table, are all generated from their encoding (see Opcodes::CB_opcode)
+    // Unprefixed opcodes which are unused by the Gameboy fall back to doing nothing
+    template <int opcode>
+    int CPU::execute_opcode(CPU& cpu) {
+        if constexpr (opcode >= 0x100) return Opcodes::CB_opcode<opcode & 0xFF>(cpu);
+        else return 0;
+    }
+
+
+    // Unprefixed opcode handlers
+    template <> int CPU::execute_opcode<0x00>(CPU& cpu) {return Opcodes::NOP(cpu);}
+    template <> int CPU::execute_opcode<0x01>(CPU& cpu) {return Opcodes::LD_rr_u16(cpu, cpu.BC);}
+    template <> int CPU::execute_opcode<0x02>(CPU& cpu) {return Opcodes::LD_ptr_rr_A(cpu, cpu.BC);}
+    template <> int CPU::execute_opcode<0x03>(CPU& cpu) {return Opcodes::INC_rr(cpu, cpu.BC);}
+    template <> int CPU::execute_opcode<0x04>(CPU& cpu) {return Opcodes::INC_r(cpu, cpu.B);}
+    template <> int CPU::execute_opcode<0x05>(CPU& cpu) {return Opcodes::DEC_r(cpu, cpu.B);}
+    template <> int CPU::execute_opcode<0x06>(CPU& cpu) {return Opcodes::LD_r_u8(cpu, cpu.B);}
+    template <> int CPU::execute_opcode<0x07>(CPU& cpu) {return Opcodes::RLCA(cpu);}
+    template <> int CPU::execute_opcode<0x08>(CPU& cpu) {return Opcodes::LD_ptr_u16_SP(cpu);}
+    template <> int CPU::execute_opcode<0x09>(CPU& cpu) {return Opcodes::ADD_HL_rr(cpu, cpu.BC);}
+    template <> int CPU::execute_opcode<0x0A>(CPU& cpu) {return Opcodes::LD_A_ptr_rr(cpu, cpu.BC);}
+    template <> int CPU::execute_opcode<0x0B>(CPU& cpu) {return Opcodes::DEC_rr(cpu, cpu.BC);}
+    template <> int CPU::execute_opcode<0x0C>(CPU& cpu) {return Opcodes::INC_r(cpu, cpu.C);}
+    template <> int CPU::execute_opcode<0x0D>(CPU& cpu) {return Opcodes::DEC_r(cpu, cpu.C);}
+    template <> int CPU::execute_opcode<0x0E>(CPU& cpu) {return Opcodes::LD_r_u8(cpu, cpu.C);}
+    template <> int CPU::execute_opcode<0x0F>(CPU& cpu) {return Opcodes::RRCA(cpu);}
+    template <> int CPU::execute_opcode<0x11>(CPU& cpu) {return Opcodes::LD_rr_u16(cpu, cpu.DE);}
+    template <> int CPU::execute_opcode<0x12>(CPU& cpu) {return Opcodes::LD_ptr_rr_A(cpu, cpu.DE);}
+    template <> int CPU::execute_opcode<0x13>(CPU& cpu) {return Opcodes::INC_rr(cpu, cpu.DE);}
+    template <> int CPU::execute_opcode<0x14>(CPU& cpu) {return Opcodes::INC_r(cpu, cpu.D);}
+    template <> int CPU::execute_opcode<0x15>(CPU& cpu) {return Opcodes::DEC_r(cpu, cpu.D);}
+    template <> int CPU::execute_opcode<0x16>(CPU& cpu) {return Opcodes::LD_r_u8(cpu, cpu.D);}
+    template <> int CPU::execute_opcode<0x17>(CPU& cpu) {return Opcodes::RLA(cpu);}
+    template <> int CPU::execute_opcode<0x18>(CPU& cpu) {return Opcodes::JR_s8(cpu);}
+    template <> int CPU::execute_opcode<0x19>(CPU& cpu) {return Opcodes::ADD_HL_rr(cpu, cpu.DE);}
+    template <> int CPU::execute_opcode<0x1A>(CPU& cpu) {return Opcodes::LD_A_ptr_rr(cpu, cpu.DE);}
+    template <> int CPU::execute_opcode<0x1B>(CPU& cpu) {return Opcodes::DEC_rr(cpu, cpu.DE);}
+    template <> int CPU::execute_opcode<0x1C>(CPU& cpu) {return Opcodes::INC_r(cpu, cpu.E);}
+    template <> int CPU::execute_opcode<0x1D>(CPU& cpu) {return Opcodes::DEC_r(cpu, cpu.E);}
+    template <> int CPU::execute_opcode<0x1E>(CPU& cpu) {return Opcodes::LD_r_u8(cpu, cpu.E);}
+    template <> int CPU::execute_opcode<0x1F>(CPU& cpu) {return Opcodes::RRA(cpu);}
+    template <> int CPU::execute_opcode<0x20>(CPU& cpu) {return Opcodes::JR_cc_s8(cpu, IS_NOT_ZERO);}
+    template <> int CPU::execute_opcode<0x21>(CPU& cpu) {return Opcodes::LD_rr_u16(cpu, cpu.HL);}
+    template <> int CPU::execute_opcode<0x22>(CPU& cpu) {return Opcodes::LDI_ptr_HL_A(cpu);}
+    template <> int CPU::execute_opcode<0x23>(CPU& cpu) {return Opcodes::INC_rr(cpu, cpu.HL);}
+    template <> int CPU::execute_opcode<0x24>(CPU& cpu) {return Opcodes::INC_r(cpu, cpu.H);}
+    template <> int CPU::execute_opcode<0x25>(CPU& cpu) {return Opcodes::DEC_r(cpu, cpu.H);}
+    template <> int CPU::execute_opcode<0x26>(CPU& cpu) {return Opcodes::LD_r_u8(cpu, cpu.H);}
+    template <> int CPU::execute_opcode<0x27>(CPU& cpu) {return Opcodes::DAA(cpu);}
+    template <> int CPU::execute_opcode<0x28>(CPU& cpu) {return Opcodes::JR_cc_s8(cpu, IS_ZERO);}
+    template <> int CPU::execute_opcode<0x29>(CPU& cpu) {return Opcodes::ADD_HL_rr(cpu, cpu.HL);}
+    template <> int CPU::execute_opcode<0x2A>(CPU& cpu) {return Opcodes::LDI_A_ptr_HL(cpu);}
+    template <> int CPU::execute_opcode<0x2B>(CPU& cpu) {return Opcodes::DEC_rr(cpu, cpu.HL);}
+    template <> int CPU::execute_opcode<0x2C>(CPU& cpu) {return Opcodes::INC_r(cpu, cpu.L);}
+    template <> int CPU::execute_opcode<0x2D>(CPU& cpu) {return Opcodes::DEC_r(cpu, cpu.L);}
+    template <> int CPU::execute_opcode<0x2E>(CPU& cpu) {return Opcodes::LD_r_u8(cpu, cpu.L);}
+    template <> int CPU::execute_opcode<0x2F>(CPU& cpu) {return Opcodes::CPL(cpu);}
+    template <> int CPU::execute_opcode<0x30>(CPU& cpu) {return Opcodes::JR_cc_s8(cpu, IS_NOT_CARRY);}
+    template <> int CPU::execute_opcode<0x31>(CPU& cpu) {return Opcodes::LD_SP_u16(cpu);}
+    template <> int CPU::execute_opcode<0x32>(CPU& cpu) {return Opcodes::LDD_ptr_HL_A(cpu);}
+    template <> int CPU::execute_opcode<0x33>(CPU& cpu) {return Opcodes::INC_SP(cpu);}
+    template <> int CPU::execute_opcode<0x34>(CPU& cpu) {return Opcodes::INC_ptr_HL(cpu);}
+    template <> int CPU::execute_opcode<0x35>(CPU& cpu) {return Opcodes::DEC_ptr_HL(cpu);}
+    template <> int CPU::execute_opcode<0x36>(CPU& cpu) {return Opcodes::LD_ptr_HL_u8(cpu);}
+    template <> int CPU::execute_opcode<0x37>(CPU& cpu) {return Opcodes::SCF(cpu);}
+    template <> int CPU::execute_opcode<0x38>(CPU& cpu) {return Opcodes::JR_cc_s8(cpu, IS_CARRY);}
+    template <> int CPU::execute_opcode<0x39>(CPU& cpu) {return Opcodes::ADD_HL_SP(cpu);}
+    template <> int CPU::execute_opcode<0x3A>(CPU& cpu) {return Opcodes::LDD_A_ptr_HL(cpu);}
+    template <> int CPU::execute_opcode<0x3B>(CPU& cpu) {return Opcodes::DEC_SP(cpu);}
+    template <> int CPU::execute_opcode<0x3C>(CPU& cpu) {return Opcodes::INC_r(cpu, cpu.A);}
+    template <> int CPU::execute_opcode<0x3D>(CPU& cpu) {return Opcodes::DEC_r(cpu, cpu.A);}
+    template <> int CPU::execute_opcode<0x3E>(CPU& cpu) {return Opcodes::LD_r_u8(cpu, cpu.A);}
+    template <> int CPU::execute_opcode<0x3F>(CPU& cpu) {return Opcodes::CCF(cpu);}
+    template <> int CPU::execute_opcode<0x40>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.B, cpu.B);}
+    template <> int CPU::execute_opcode<0x41>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.B, cpu.C);}
+    template <> int CPU::execute_opcode<0x42>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.B, cpu.D);}
+    template <> int CPU::execute_opcode<0x43>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.B, cpu.E);}
+    template <> int CPU::execute_opcode<0x44>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.B, cpu.H);}
+    template <> int CPU::execute_opcode<0x45>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.B, cpu.L);}
+    template <> int CPU::execute_opcode<0x46>(CPU& cpu) {return Opcodes::LD_r_ptr_HL(cpu, cpu.B);}
+    template <> int CPU::execute_opcode<0x47>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.B, cpu.A);}
+    template <> int CPU::execute_opcode<0x48>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.C, cpu.B);}
+    template <> int CPU::execute_opcode<0x49>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.C, cpu.C);}
+    template <> int CPU::execute_opcode<0x4A>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.C, cpu.D);}
+    template <> int CPU::execute_opcode<0x4B>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.C, cpu.E);}
+    template <> int CPU::execute_opcode<0x4C>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.C, cpu.H);}
+    template <> int CPU::execute_opcode<0x4D>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.C, cpu.L);}
+    template <> int CPU::execute_opcode<0x4E>(CPU& cpu) {return Opcodes::LD_r_ptr_HL(cpu, cpu.C);}
+    template <> int CPU::execute_opcode<0x4F>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.C, cpu.A);}
+    template <> int CPU::execute_opcode<0x50>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.D, cpu.B);}
+    template <> int CPU::execute_opcode<0x51>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.D, cpu.C);}
+    template <> int CPU::execute_opcode<0x52>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.D, cpu.D);}
+    template <> int CPU::execute_opcode<0x53>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.D, cpu.E);}
+    template <> int CPU::execute_opcode<0x54>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.D, cpu.H);}
+    template <> int CPU::execute_opcode<0x55>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.D, cpu.L);}
+    template <> int CPU::execute_opcode<0x56>(CPU& cpu) {return Opcodes::LD_r_ptr_HL(cpu, cpu.D);}
+    template <> int CPU::execute_opcode<0x57>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.D, cpu.A);}
+    template <> int CPU::execute_opcode<0x58>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.E, cpu.B);}
+    template <> int CPU::execute_opcode<0x59>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.E, cpu.C);}
+    template <> int CPU::execute_opcode<0x5A>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.E, cpu.D);}
+    template <> int CPU::execute_opcode<0x5B>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.E, cpu.E);}
+    template <> int CPU::execute_opcode<0x5C>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.E, cpu.H);}
+    template <> int CPU::execute_opcode<0x5D>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.E, cpu.L);}
+    template <> int CPU::execute_opcode<0x5E>(CPU& cpu) {return Opcodes::LD_r_ptr_HL(cpu, cpu.E);}
+    template <> int CPU::execute_opcode<0x5F>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.E, cpu.A);}
+    template <> int CPU::execute_opcode<0x60>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.H, cpu.B);}
+    template <> int CPU::execute_opcode<0x61>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.H, cpu.C);}
+    template <> int CPU::execute_opcode<0x62>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.H, cpu.D);}
+    template <> int CPU::execute_opcode<0x63>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.H, cpu.E);}
+    template <> int CPU::execute_opcode<0x64>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.H, cpu.H);}
+    template <> int CPU::execute_opcode<0x65>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.H, cpu.L);}
+    template <> int CPU::execute_opcode<0x66>(CPU& cpu) {return Opcodes::LD_r_ptr_HL(cpu, cpu.H);}
+    template <> int CPU::execute_opcode<0x67>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.H, cpu.A);}
+    template <> int CPU::execute_opcode<0x68>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.L, cpu.B);}
+    template <> int CPU::execute_opcode<0x69>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.L, cpu.C);}
+    template <> int CPU::execute_opcode<0x6A>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.L, cpu.D);}
+    template <> int CPU::execute_opcode<0x6B>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.L, cpu.E);}
+    template <> int CPU::execute_opcode<0x6C>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.L, cpu.H);}
+    template <> int CPU::execute_opcode<0x6D>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.L, cpu.L);}
+    template <> int CPU::execute_opcode<0x6E>(CPU& cpu) {return Opcodes::LD_r_ptr_HL(cpu, cpu.L);}
+    template <> int CPU::execute_opcode<0x6F>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.L, cpu.A);}
+    template <> int CPU::execute_opcode<0x70>(CPU& cpu) {return Opcodes::LD_ptr_HL_r(cpu, cpu.B);}
+    template <> int CPU::execute_opcode<0x71>(CPU& cpu) {return Opcodes::LD_ptr_HL_r(cpu, cpu.C);}
+    template <> int CPU::execute_opcode<0x72>(CPU& cpu) {return Opcodes::LD_ptr_HL_r(cpu, cpu.D);}
+    template <> int CPU::execute_opcode<0x73>(CPU& cpu) {return Opcodes::LD_ptr_HL_r(cpu, cpu.E);}
+    template <> int CPU::execute_opcode<0x74>(CPU& cpu) {return Opcodes::LD_ptr_HL_r(cpu, cpu.H);}
+    template <> int CPU::execute_opcode<0x75>(CPU& cpu) {return Opcodes::LD_ptr_HL_r(cpu, cpu.L);}
+    template <> int CPU::execute_opcode<0x76>(CPU& cpu) {return Opcodes::HALT(cpu);}
+    template <> int CPU::execute_opcode<0x77>(CPU& cpu) {return Opcodes::LD_ptr_HL_r(cpu, cpu.A);}
+    template <> int CPU::execute_opcode<0x78>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.A, cpu.B);}
+    template <> int CPU::execute_opcode<0x79>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.A, cpu.C);}
+    template <> int CPU::execute_opcode<0x7A>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.A, cpu.D);}
+    template <> int CPU::execute_opcode<0x7B>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.A, cpu.E);}
+    template <> int CPU::execute_opcode<0x7C>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.A, cpu.H);}
+    template <> int CPU::execute_opcode<0x7D>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.A, cpu.L);}
+    template <> int CPU::execute_opcode<0x7E>(CPU& cpu) {return Opcodes::LD_r_ptr_HL(cpu, cpu.A);}
+    template <> int CPU::execute_opcode<0x7F>(CPU& cpu) {return Opcodes::LD_r_r(cpu, cpu.A, cpu.A);}
+    template <> int CPU::execute_opcode<0x80>(CPU& cpu) {return Opcodes::ADD_r(cpu, cpu.B);}
+    template <> int CPU::execute_opcode<0x81>(CPU& cpu) {return Opcodes::ADD_r(cpu, cpu.C);}
+    template <> int CPU::execute_opcode<0x82>(CPU& cpu) {return Opcodes::ADD_r(cpu, cpu.D);}
+    template <> int CPU::execute_opcode<0x83>(CPU& cpu) {return Opcodes::ADD_r(cpu, cpu.E);}
+    template <> int CPU::execute_opcode<0x84>(CPU& cpu) {return Opcodes::ADD_r(cpu, cpu.H);}
+    template <> int CPU::execute_opcode<0x85>(CPU& cpu) {return Opcodes::ADD_r(cpu, cpu.L);}
+    template <> int CPU::execute_opcode<0x86>(CPU& cpu) {return Opcodes::ADD_ptr_HL(cpu);}
+    template <> int CPU::execute_opcode<0x87>(CPU& cpu) {return Opcodes::ADD_r(cpu, cpu.A);}
+    template <> int CPU::execute_opcode<0x88>(CPU& cpu) {return Opcodes::ADC_r(cpu, cpu.B);}
+    template <> int CPU::execute_opcode<0x89>(CPU& cpu) {return Opcodes::ADC_r(cpu, cpu.C);}
+    template <> int CPU::execute_opcode<0x8A>(CPU& cpu) {return Opcodes::ADC_r(cpu, cpu.D);}
+    template <> int CPU::execute_opcode<0x8B>(CPU& cpu) {return Opcodes::ADC_r(cpu, cpu.E);}
+    template <> int CPU::execute_opcode<0x8C>(CPU& cpu) {return Opcodes::ADC_r(cpu, cpu.H);}
+    template <> int CPU::execute_opcode<0x8D>(CPU& cpu) {return Opcodes::ADC_r(cpu, cpu.L);}
+    template <> int CPU::execute_opcode<0x8E>(CPU& cpu) {return Opcodes::ADC_ptr_HL(cpu);}
+    template <> int CPU::execute_opcode<0x8F>(CPU& cpu) {return Opcodes::ADC_r(cpu, cpu.A);}
+    template <> int CPU::execute_opcode<0x90>(CPU& cpu) {return Opcodes::SUB_r(cpu, cpu.B);}
+    template <> int CPU::execute_opcode<0x91>(CPU& cpu) {return Opcodes::SUB_r(cpu, cpu.C);}
+    template <> int CPU::execute_opcode<0x92>(CPU& cpu) {return Opcodes::SUB_r(cpu, cpu.D);}
+    template <> int CPU::execute_opcode<0x93>(CPU& cpu) {return Opcodes::SUB_r(cpu, cpu.E);}
+    template <> int CPU::execute_opcode<0x94>(CPU& cpu) {return Opcodes::SUB_r(cpu, cpu.H);}
+    template <> int CPU::execute_opcode<0x95>(CPU& cpu) {return Opcodes::SUB_r(cpu, cpu.L);}
+    template <> int CPU::execute_opcode<0x96>(CPU& cpu) {return Opcodes::SUB_ptr_HL(cpu);}
+    template <> int CPU::execute_opcode<0x97>(CPU& cpu) {return Opcodes::SUB_r(cpu, cpu.A);}
+    template <> int CPU::execute_opcode<0x98>(CPU& cpu) {return Opcodes::SBC_r(cpu, cpu.B);}
+    template <> int CPU::execute_opcode<0x99>(CPU& cpu) {return Opcodes::SBC_r(cpu, cpu.C);}
+    template <> int CPU::execute_opcode<0x9A>(CPU& cpu) {return Opcodes::SBC_r(cpu, cpu.D);}
+    template <> int CPU::execute_opcode<0x9B>(CPU& cpu) {return Opcodes::SBC_r(cpu, cpu.E);}
+    template <> int CPU::execute_opcode<0x9C>(CPU& cpu) {return Opcodes::SBC_r(cpu, cpu.H);}
+    template <> int CPU::execute_opcode<0x9D>(CPU& cpu) {return Opcodes::SBC_r(cpu, cpu.L);}
+    template <> int CPU::execute_opcode<0x9E>(CPU& cpu) {return Opcodes::SBC_ptr_HL(cpu);}
+    template <> int CPU::execute_opcode<0x9F>(CPU& cpu) {return Opcodes::SBC_r(cpu, cpu.A);}
+    template <> int CPU::execute_opcode<0xA0>(CPU& cpu) {return Opcodes::AND_r(cpu, cpu.B);}
+    template <> int CPU::execute_opcode<0xA1>(CPU& cpu) {return Opcodes::AND_r(cpu, cpu.C);}
+    template <> int CPU::execute_opcode<0xA2>(CPU& cpu) {return Opcodes::AND_r(cpu, cpu.D);}
+    template <> int CPU::execute_opcode<0xA3>(CPU& cpu) {return Opcodes::AND_r(cpu, cpu.E);}
+    template <> int CPU::execute_opcode<0xA4>(CPU& cpu) {return Opcodes::AND_r(cpu, cpu.H);}
+    template <> int CPU::execute_opcode<0xA5>(CPU& cpu) {return Opcodes::AND_r(cpu, cpu.L);}
+    template <> int CPU::execute_opcode<0xA6>(CPU& cpu) {return Opcodes::AND_ptr_HL(cpu);}
+    template <> int CPU::execute_opcode<0xA7>(CPU& cpu) {return Opcodes::AND_r(cpu, cpu.A);}
+    template <> int CPU::execute_opcode<0xA8>(CPU& cpu) {return Opcodes::XOR_r(cpu, cpu.B);}
+    template <> int CPU::execute_opcode<0xA9>(CPU& cpu) {return Opcodes::XOR_r(cpu, cpu.C);}
+    template <> int CPU::execute_opcode<0xAA>(CPU& cpu) {return Opcodes::XOR_r(cpu, cpu.D);}
+    template <> int CPU::execute_opcode<0xAB>(CPU& cpu) {return Opcodes::XOR_r(cpu, cpu.E);}
+    template <> int CPU::execute_opcode<0xAC>(CPU& cpu) {return Opcodes::XOR_r(cpu, cpu.H);}
+    template <> int CPU::execute_opcode<0xAD>(CPU& cpu) {return Opcodes::XOR_r(cpu, cpu.L);}
+    template <> int CPU::execute_opcode<0xAE>(CPU& cpu) {return Opcodes::XOR_ptr_HL(cpu);}
+    template <> int CPU::execute_opcode<0xAF>(CPU& cpu) {return Opcodes::XOR_r(cpu, cpu.A);}
+    template <> int CPU::execute_opcode<0xB0>(CPU& cpu) {return Opcodes::OR_r(cpu, cpu.B);}
+    template <> int CPU::execute_opcode<0xB1>(CPU& cpu) {return Opcodes::OR_r(cpu, cpu.C);}
+    template <> int CPU::execute_opcode<0xB2>(CPU& cpu) {return Opcodes::OR_r(cpu, cpu.D);}
+    template <> int CPU::execute_opcode<0xB3>(CPU& cpu) {return Opcodes::OR_r(cpu, cpu.E);}
+    template <> int CPU::execute_opcode<0xB4>(CPU& cpu) {return Opcodes::OR_r(cpu, cpu.H);}
+    template <> int CPU::execute_opcode<0xB5>(CPU& cpu) {return Opcodes::OR_r(cpu, cpu.L);}
+    template <> int CPU::execute_opcode<0xB6>(CPU& cpu) {return Opcodes::OR_ptr_HL(cpu);}
+    template <> int CPU::execute_opcode<0xB7>(CPU& cpu) {return Opcodes::OR_r(cpu, cpu.A);}
+    template <> int CPU::execute_opcode<0xB8>(CPU& cpu) {return Opcodes::CP_r(cpu, cpu.B);}
+    template <> int CPU::execute_opcode<0xB9>(CPU& cpu) {return Opcodes::CP_r(cpu, cpu.C);}
+    template <> int CPU::execute_opcode<0xBA>(CPU& cpu) {return Opcodes::CP_r(cpu, cpu.D);}
+    template <> int CPU::execute_opcode<0xBB>(CPU& cpu) {return Opcodes::CP_r(cpu, cpu.E);}
+    template <> int CPU::execute_opcode<0xBC>(CPU& cpu) {return Opcodes::CP_r(cpu, cpu.H);}
+    template <> int CPU::execute_opcode<0xBD>(CPU& cpu) {return Opcodes::CP_r(cpu, cpu.L);}
+    template <> int CPU::execute_opcode<0xBE>(CPU& cpu) {return Opcodes::CP_ptr_HL(cpu);}
+    template <> int CPU::execute_opcode<0xBF>(CPU& cpu) {return Opcodes::CP_r(cpu, cpu.A);}
+    template <> int CPU::execute_opcode<0xC0>(CPU& cpu) {return Opcodes::RET_cc(cpu, IS_NOT_ZERO);}
+    template <> int CPU::execute_opcode<0xC1>(CPU& cpu) {return Opcodes::POP_rr(cpu, cpu.BC);}
+    template <> int CPU::execute_opcode<0xC2>(CPU& cpu) {return Opcodes::JP_cc_u16(cpu, IS_NOT_ZERO);}
+    template <> int CPU::execute_opcode<0xC3>(CPU& cpu) {return Opcodes::JP_u16(cpu);}
+    template <> int CPU::execute_opcode<0xC4>(CPU& cpu) {return Opcodes::CALL_cc_u16(cpu, IS_NOT_ZERO);}
+    template <> int CPU::execute_opcode<0xC5>(CPU& cpu) {return Opcodes::PUSH_rr(cpu, cpu.BC);}
+    template <> int CPU::execute_opcode<0xC6>(CPU& cpu) {return Opcodes::ADD_u8(cpu);}
+    template <> int CPU::execute_opcode<0xC7>(CPU& cpu) {return Opcodes::RST_n(cpu, 0);}
+    template <> int CPU::execute_opcode<0xC8>(CPU& cpu) {return Opcodes::RET_cc(cpu, IS_ZERO);}
+    template <> int CPU::execute_opcode<0xC9>(CPU& cpu) {return Opcodes::RET(cpu);}
+    template <> int CPU::execute_opcode<0xCA>(CPU& cpu) {return Opcodes::JP_cc_u16(cpu, IS_ZERO);}
+    template <> int CPU::execute_opcode<0xCB>(CPU& cpu) {return opcode_handlers[0x100 | cpu.fetch()](cpu);}
+    template <> int CPU::execute_opcode<0xCC>(CPU& cpu) {return Opcodes::CALL_cc_u16(cpu, IS_ZERO);}
+    template <> int CPU::execute_opcode<0xCD>(CPU& cpu) {return Opcodes::CALL_u16(cpu);}
+    template <> int CPU::execute_opcode<0xCE>(CPU& cpu) {return Opcodes::ADC_u8(cpu);}
+    template <> int CPU::execute_opcode<0xCF>(CPU& cpu) {return Opcodes::RST_n(cpu, 1);}
+    template <> int CPU::execute_opcode<0xD0>(CPU& cpu) {return Opcodes::RET_cc(cpu, IS_NOT_CARRY);}
+    template <> int CPU::execute_opcode<0xD1>(CPU& cpu) {return Opcodes::POP_rr(cpu, cpu.DE);}
+    template <> int CPU::execute_opcode<0xD2>(CPU& cpu) {return Opcodes::JP_cc_u16(cpu, IS_NOT_CARRY);}
+    template <> int CPU::execute_opcode<0xD4>(CPU& cpu) {return Opcodes::CALL_cc_u16(cpu, IS_NOT_CARRY);}
+    template <> int CPU::execute_opcode<0xD5>(CPU& cpu) {return Opcodes::PUSH_rr(cpu, cpu.DE);}
+    template <> int CPU::execute_opcode<0xD6>(CPU& cpu) {return Opcodes::SUB_u8(cpu);}
+    template <> int CPU::execute_opcode<0xD7>(CPU& cpu) {return Opcodes::RST_n(cpu, 2);}
+    template <> int CPU::execute_opcode<0xD8>(CPU& cpu) {return Opcodes::RET_cc(cpu, IS_CARRY);}
+    template <> int CPU::execute_opcode<0xD9>(CPU& cpu) {return Opcodes::RETI(cpu);}
+    template <> int CPU::execute_opcode<0xDA>(CPU& cpu) {return Opcodes::JP_cc_u16(cpu, IS_CARRY);}
+    template <> int CPU::execute_opcode<0xDC>(CPU& cpu) {return Opcodes::CALL_cc_u16(cpu, IS_CARRY);}
+    template <> int CPU::execute_opcode<0xDE>(CPU& cpu) {return Opcodes::SBC_u8(cpu);}
+    template <> int CPU::execute_opcode<0xDF>(CPU& cpu) {return Opcodes::RST_n(cpu, 3);}
+    template <> int CPU::execute_opcode<0xE0>(CPU& cpu) {return Opcodes::LDH_ptr_u8_A(cpu);}
+    template <> int CPU::execute_opcode<0xE1>(CPU& cpu) {return Opcodes::POP_rr(cpu, cpu.HL);}
+    template <> int CPU::execute_opcode<0xE2>(CPU& cpu) {return Opcodes::LDH_ptr_C_A(cpu);}
+    template <> int CPU::execute_opcode<0xE5>(CPU& cpu) {return Opcodes::PUSH_rr(cpu, cpu.HL);}
+    template <> int CPU::execute_opcode<0xE6>(CPU& cpu) {return Opcodes::AND_u8(cpu);}
+    template <> int CPU::execute_opcode<0xE7>(CPU& cpu) {return Opcodes::RST_n(cpu, 4);}
+    template <> int CPU::execute_opcode<0xE8>(CPU& cpu) {return Opcodes::ADD_SP_s8(cpu);}
+    template <> int CPU::execute_opcode<0xE9>(CPU& cpu) {return Opcodes::JP_HL(cpu);}
+    template <> int CPU::execute_opcode<0xEA>(CPU& cpu) {return Opcodes::LD_ptr_u16_A(cpu);}
+    template <> int CPU::execute_opcode<0xEE>(CPU& cpu) {return Opcodes::XOR_u8(cpu);}
+    template <> int CPU::execute_opcode<0xEF>(CPU& cpu) {return Opcodes::RST_n(cpu, 5);}
+    template <> int CPU::execute_opcode<0xF0>(CPU& cpu) {return Opcodes::LDH_A_ptr_u8(cpu);}
+    template <> int CPU::execute_opcode<0xF1>(CPU& cpu) {return Opcodes::POP_AF(cpu);}
+    template <> int CPU::execute_opcode<0xF2>(CPU& cpu) {return Opcodes::LDH_A_ptr_C(cpu);}
+    template <> int CPU::execute_opcode<0xF3>(CPU& cpu) {return Opcodes::DI(cpu);}
+    template <> int CPU::execute_opcode<0xF5>(CPU& cpu) {return Opcodes::PUSH_AF(cpu);}
+    template <> int CPU::execute_opcode<0xF6>(CPU& cpu) {return Opcodes::OR_u8(cpu);}
+    template <> int CPU::execute_opcode<0xF7>(CPU& cpu) {return Opcodes::RST_n(cpu, 6);}
+    template <> int CPU::execute_opcode<0xF8>(CPU& cpu) {return Opcodes::LD_HL_SP_s8(cpu);}
+    template <> int CPU::execute_opcode<0xF9>(CPU& cpu) {return Opcodes::LD_SP_HL(cpu);}
+    template <> int CPU::execute_opcode<0xFA>(CPU& cpu) {return Opcodes::LD_A_ptr_u16(cpu);}
+    template <> int CPU::execute_opcode<0xFB>(CPU& cpu) {return Opcodes::EI(cpu);}
+    template <> int CPU::execute_opcode<0xFE>(CPU& cpu) {return Opcodes::CP_u8(cpu);}
+    template <> int CPU::execute_opcode<0xFF>(CPU& cpu) {return Opcodes::RST_n(cpu, 7);}
+
+
+    // Generates the handler table at compile time, one entry for each of the 256 unprefixed and 256 prefixed opcodes
+    template <std::size_t... opcodes>
+    constexpr std::array<CPU::OpcodeHandler, 512> CPU::generate_opcode_handlers(std::index_sequence<opcodes...>) {
+        return {&execute_opcode<opcodes>...};
+    }
+
+
+    const std::array<CPU::OpcodeHandler, 512> CPU::opcode_handlers = generate_opcode_handlers(std::make_index_sequence<512>());
+
+
+    #if defined(__GNUC__)
+        // The computed goto variant of the handler table, using the labels as values extension of GCC and Clang
+        // Every handler is expanded inline behind its own label, so an opcode costs an indexed jump rather than a call
+        // The 0xCB prefix jumps straight into the prefixed half of the labels after its second fetch
+        int CPU::execute_computed_goto(U8 opcode) {
+            #define OPCODE_ROW(OPCODE, page, row) OPCODE(page, row##0) OPCODE(page, row##1) OPCODE(page, row##2) OPCODE(page, row##3) \
+                OPCODE(page, row##4) OPCODE(page, row##5) OPCODE(page, row##6) OPCODE(page, row##7) OPCODE(page, row##8) OPCODE(page, row##9) \
+                OPCODE(page, row##A) OPCODE(page, row##B) OPCODE(page, row##C) OPCODE(page, row##D) OPCODE(page, row##E) OPCODE(page, row##F)
+            #define OPCODE_PAGE(OPCODE, page) OPCODE_ROW(OPCODE, page, 0) OPCODE_ROW(OPCODE, page, 1) OPCODE_ROW(OPCODE, page, 2) OPCODE_ROW(OPCODE, page, 3) \
+                OPCODE_ROW(OPCODE, page, 4) OPCODE_ROW(OPCODE, page, 5) OPCODE_ROW(OPCODE, page, 6) OPCODE_ROW(OPCODE, page, 7) \
+                OPCODE_ROW(OPCODE, page, 8) OPCODE_ROW(OPCODE, page, 9) OPCODE_ROW(OPCODE, page, A) OPCODE_ROW(OPCODE, page, B) \
+                OPCODE_ROW(OPCODE, page, C) OPCODE_ROW(OPCODE, page, D) OPCODE_ROW(OPCODE, page, E) OPCODE_ROW(OPCODE, page, F)
+            #define OPCODE_LABEL_ADDRESS(page, opcode) &&opcode_##page##_##opcode,
+            #define OPCODE_LABEL(page, opcode) opcode_##page##_##opcode: return execute_opcode<page << 8 | 0x##opcode>(*this);
+
+            static void* const labels[512] = {OPCODE_PAGE(OPCODE_LABEL_ADDRESS, 0) OPCODE_PAGE(OPCODE_LABEL_ADDRESS, 1)};
+
+            // Enable interrupts after delay
+            if (can_enable_interrupts) {
+                is_interrupt_master_enabled = true;
+                can_enable_interrupts = false;
             }
+
+            if (opcode == 0xCB) goto *labels[0x100 | fetch()];
+            goto *labels[opcode];
+            OPCODE_PAGE(OPCODE_LABEL, 0)
+            OPCODE_PAGE(OPCODE_LABEL, 1)
+
+            #undef OPCODE_LABEL
+            #undef OPCODE_LABEL_ADDRESS
+            #undef OPCODE_PAGE
+            #undef OPCODE_ROW
         }
+    #endif
 
-        // Decoding unprefixed opcodes
-        else {
-            switch (opcode) {
-                case 0x00: return Opcodes::NOP(*this);
-                case 0x01: return Opcodes::LD_rr_u16(*this, BC);
-                case 0x02: return Opcodes::LD_ptr_rr_A(*this, BC);
-                case 0x03: return Opcodes::INC_rr(*this, BC);
-                case 0x04: return Opcodes::INC_r(*this, B);
-                case 0x05: return Opcodes::DEC_r(*this, B);
-                case 0x06: return Opcodes::LD_r_u8(*this, B);
-                case 0x07: return Opcodes::RLCA(*this);
-                case 0x08: return Opcodes::LD_ptr_u16_SP(*this);
-                case 0x09: return Opcodes::ADD_HL_rr(*this, BC);
-                case 0x0A: return Opcodes::LD_A_ptr_rr(*this, BC);
-                case 0x0B: return Opcodes::DEC_rr(*this, BC);
-                case 0x0C: return Opcodes::INC_r(*this, C);
-                case 0x0D: return Opcodes::DEC_r(*this, C);
-                case 0x0E: return Opcodes::LD_r_u8(*this, C);
-                case 0x0F: return Opcodes::RRCA(*this);
-                case 0x11: return Opcodes::LD_rr_u16(*this, DE);
-                case 0x12: return Opcodes::LD_ptr_rr_A(*this, DE);
-                case 0x13: return Opcodes::INC_rr(*this, DE);
-                case 0x14: return Opcodes::INC_r(*this, D);
-                case 0x15: return Opcodes::DEC_r(*this, D);
-                case 0x16: return Opcodes::LD_r_u8(*this, D);
-                case 0x17: return Opcodes::RLA(*this);
-                case 0x18: return Opcodes::JR_s8(*this);
-                case 0x19: return Opcodes::ADD_HL_rr(*this, DE);
-                case 0x1A: return Opcodes::LD_A_ptr_rr(*this, DE);
-                case 0x1B: return Opcodes::DEC_rr(*this, DE);
-                case 0x1C: return Opcodes::INC_r(*this, E);
-                case 0x1D: return Opcodes::DEC_r(*this, E);
-                case 0x1E: return Opcodes::LD_r_u8(*this, E);
-                case 0x1F: return Opcodes::RRA(*this);
-                case 0x20: return Opcodes::JR_cc_s8(*this, IS_NOT_ZERO);
-                case 0x21: return Opcodes::LD_rr_u16(*this, HL);
-                case 0x22: return Opcodes::LDI_ptr_HL_A(*this);
-                case 0x23: return Opcodes::INC_rr(*this, HL);
-                case 0x24: return Opcodes::INC_r(*this, H);
-                case 0x25: return Opcodes::DEC_r(*this, H);
-                case 0x26: return Opcodes::LD_r_u8(*this, H);
-                case 0x27: return Opcodes::DAA(*this);
-                case 0x28: return Opcodes::JR_cc_s8(*this, IS_ZERO);
-                case 0x29: return Opcodes::ADD_HL_rr(*this, HL);
-                case 0x2A: return Opcodes::LDI_A_ptr_HL(*this);
-                case 0x2B: return Opcodes::DEC_rr(*this, HL);
-                case 0x2C: return Opcodes::INC_r(*this, L);
-                case 0x2D: return Opcodes::DEC_r(*this, L);
-                case 0x2E: return Opcodes::LD_r_u8(*this, L);
-                case 0x2F: return Opcodes::CPL(*this);
-                case 0x30: return Opcodes::JR_cc_s8(*this, IS_NOT_CARRY);
-                case 0x31: return Opcodes::LD_SP_u16(*this);
-                case 0x32: return Opcodes::LDD_ptr_HL_A(*this);
-                case 0x33: return Opcodes::INC_SP(*this);
-                case 0x34: return Opcodes::INC_ptr_HL(*this);
-                case 0x35: return Opcodes::DEC_ptr_HL(*this);
-                case 0x36: return Opcodes::LD_ptr_HL_u8(*this);
-                case 0x37: return Opcodes::SCF(*this);
-                case 0x38: return Opcodes::JR_cc_s8(*this, IS_CARRY);
-                case 0x39: return Opcodes::ADD_HL_SP(*this);
-                case 0x3A: return Opcodes::LDD_A_ptr_HL(*this);
-                case 0x3B: return Opcodes::DEC_SP(*this);
-                case 0x3C: return Opcodes::INC_r(*this, A);
-                case 0x3D: return Opcodes::DEC_r(*this, A);
-                case 0x3E: return Opcodes::LD_r_u8(*this, A);
-                case 0x3F: return Opcodes::CCF(*this);
-                case 0x40: return Opcodes::LD_r_r(*this, B, B);
-                case 0x41: return Opcodes::LD_r_r(*this, B, C);
-                case 0x42: return Opcodes::LD_r_r(*this, B, D);
-                case 0x43: return Opcodes::LD_r_r(*this, B, E);
-                case 0x44: return Opcodes::LD_r_r(*this, B, H);
-                case 0x45: return Opcodes::LD_r_r(*this, B, L);
-                case 0x46: return Opcodes::LD_r_ptr_HL(*this, B);
-                case 0x47: return Opcodes::LD_r_r(*this, B, A);
-                case 0x48: return Opcodes::LD_r_r(*this, C, B);
-                case 0x49: return Opcodes::LD_r_r(*this, C, C);
-                case 0x4A: return Opcodes::LD_r_r(*this, C, D);
-                case 0x4B: return Opcodes::LD_r_r(*this, C, E);
-                case 0x4C: return Opcodes::LD_r_r(*this, C, H);
-                case 0x4D: return Opcodes::LD_r_r(*this, C, L);
-                case 0x4E: return Opcodes::LD_r_ptr_HL(*this, C);
-                case 0x4F: return Opcodes::LD_r_r(*this, C, A);
-                case 0x50: return Opcodes::LD_r_r(*this, D, B);
-                case 0x51: return Opcodes::LD_r_r(*this, D, C);
-                case 0x52: return Opcodes::LD_r_r(*this, D, D);
-                case 0x53: return Opcodes::LD_r_r(*this, D, E);
-                case 0x54: return Opcodes::LD_r_r(*this, D, H);
-                case 0x55: return Opcodes::LD_r_r(*this, D, L);
-                case 0x56: return Opcodes::LD_r_ptr_HL(*this, D);
-                case 0x57: return Opcodes::LD_r_r(*this, D, A);
-                case 0x58: return Opcodes::LD_r_r(*this, E, B);
-                case 0x59: return Opcodes::LD_r_r(*this, E, C);
-                case 0x5A: return Opcodes::LD_r_r(*this, E, D);
-                case 0x5B: return Opcodes::LD_r_r(*this, E, E);
-                case 0x5C: return Opcodes::LD_r_r(*this, E, H);
-                case 0x5D: return Opcodes::LD_r_r(*this, E, L);
-                case 0x5E: return Opcodes::LD_r_ptr_HL(*this, E);
-                case 0x5F: return Opcodes::LD_r_r(*this, E, A);
-                case 0x60: return Opcodes::LD_r_r(*this, H, B);
-                case 0x61: return Opcodes::LD_r_r(*this, H, C);
-                case 0x62: return Opcodes::LD_r_r(*this, H, D);
-                case 0x63: return Opcodes::LD_r_r(*this, H, E);
-                case 0x64: return Opcodes::LD_r_r(*this, H, H);
-                case 0x65: return Opcodes::LD_r_r(*this, H, L);
-                case 0x66: return Opcodes::LD_r_ptr_HL(*this, H);
-                case 0x67: return Opcodes::LD_r_r(*this, H, A);
-                case 0x68: return Opcodes::LD_r_r(*this, L, B);
-                case 0x69: return Opcodes::LD_r_r(*this, L, C);
-                case 0x6A: return Opcodes::LD_r_r(*this, L, D);
-                case 0x6B: return Opcodes::LD_r_r(*this, L, E);
-                case 0x6C: return Opcodes::LD_r_r(*this, L, H);
-                case 0x6D: return Opcodes::LD_r_r(*this, L, L);
-                case 0x6E: return Opcodes::LD_r_ptr_HL(*this, L);
-                case 0x6F: return Opcodes::LD_r_r(*this, L, A);
-                case 0x70: return Opcodes::LD_ptr_HL_r(*this, B);
-                case 0x71: return Opcodes::LD_ptr_HL_r(*this, C);
-                case 0x72: return Opcodes::LD_ptr_HL_r(*this, D);
-                case 0x73: return Opcodes::LD_ptr_HL_r(*this, E);
-                case 0x74: return Opcodes::LD_ptr_HL_r(*this, H);
-                case 0x75: return Opcodes::LD_ptr_HL_r(*this, L);
-                case 0x76: return Opcodes::HALT(*this);
-                case 0x77: return Opcodes::LD_ptr_HL_r(*this, A);
-                case 0x78: return Opcodes::LD_r_r(*this, A, B);
-                case 0x79: return Opcodes::LD_r_r(*this, A, C);
-                case 0x7A: return Opcodes::LD_r_r(*this, A, D);
-                case 0x7B: return Opcodes::LD_r_r(*this, A, E);
-                case 0x7C: return Opcodes::LD_r_r(*this, A, H);
-                case 0x7D: return Opcodes::LD_r_r(*this, A, L);
-                case 0x7E: return Opcodes::LD_r_ptr_HL(*this, A);
-                case 0x7F: return Opcodes::LD_r_r(*this, A, A);
-                case 0x80: return Opcodes::ADD_r(*this, B);
-                case 0x81: return Opcodes::ADD_r(*this, C);
-                case 0x82: return Opcodes::ADD_r(*this, D);
-                case 0x83: return Opcodes::ADD_r(*this, E);
-                case 0x84: return Opcodes::ADD_r(*this, H);
-                case 0x85: return Opcodes::ADD_r(*this, L);
-                case 0x86: return Opcodes::ADD_ptr_HL(*this);
-                case 0x87: return Opcodes::ADD_r(*this, A);
-                case 0x88: return Opcodes::ADC_r(*this, B);
-                case 0x89: return Opcodes::ADC_r(*this, C);
-                case 0x8A: return Opcodes::ADC_r(*this, D);
-                case 0x8B: return Opcodes::ADC_r(*this, E);
-                case 0x8C: return Opcodes::ADC_r(*this, H);
-                case 0x8D: return Opcodes::ADC_r(*this, L);
-                case 0x8E: return Opcodes::ADC_ptr_HL(*this);
-                case 0x8F: return Opcodes::ADC_r(*this, A);
-                case 0x90: return Opcodes::SUB_r(*this, B);
-                case 0x91: return Opcodes::SUB_r(*this, C);
-                case 0x92: return Opcodes::SUB_r(*this, D);
-                case 0x93: return Opcodes::SUB_r(*this, E);
-                case 0x94: return Opcodes::SUB_r(*this, H);
-                case 0x95: return Opcodes::SUB_r(*this, L);
-                case 0x96: return Opcodes::SUB_ptr_HL(*this);
-                case 0x97: return Opcodes::SUB_r(*this, A);
-                case 0x98: return Opcodes::SBC_r(*this, B);
-                case 0x99: return Opcodes::SBC_r(*this, C);
-                case 0x9A: return Opcodes::SBC_r(*this, D);
-                case 0x9B: return Opcodes::SBC_r(*this, E);
-                case 0x9C: return Opcodes::SBC_r(*this, H);
-                case 0x9D: return Opcodes::SBC_r(*this, L);
-                case 0x9E: return Opcodes::SBC_ptr_HL(*this);
-                case 0x9F: return Opcodes::SBC_r(*this, A);
-                case 0xA0: return Opcodes::AND_r(*this, B);
-                case 0xA1: return Opcodes::AND_r(*this, C);
-                case 0xA2: return Opcodes::AND_r(*this, D);
-                case 0xA3: return Opcodes::AND_r(*this, E);
-                case 0xA4: return Opcodes::AND_r(*this, H);
-                case 0xA5: return Opcodes::AND_r(*this, L);
-                case 0xA6: return Opcodes::AND_ptr_HL(*this);
-                case 0xA7: return Opcodes::AND_r(*this, A);
-                case 0xA8: return Opcodes::XOR_r(*this, B);
-                case 0xA9: return Opcodes::XOR_r(*this, C);
-                case 0xAA: return Opcodes::XOR_r(*this, D);
-                case 0xAB: return Opcodes::XOR_r(*this, E);
-                case 0xAC: return Opcodes::XOR_r(*this, H);
-                case 0xAD: return Opcodes::XOR_r(*this, L);
-                case 0xAE: return Opcodes::XOR_ptr_HL(*this);
-                case 0xAF: return Opcodes::XOR_r(*this, A);
-                case 0xB0: return Opcodes::OR_r(*this, B);
-                case 0xB1: return Opcodes::OR_r(*this, C);
-                case 0xB2: return Opcodes::OR_r(*this, D);
-                case 0xB3: return Opcodes::OR_r(*this, E);
-                case 0xB4: return Opcodes::OR_r(*this, H);
-                case 0xB5: return Opcodes::OR_r(*this, L);
-                case 0xB6: return Opcodes::OR_ptr_HL(*this);
-                case 0xB7: return Opcodes::OR_r(*this, A);
-                case 0xB8: return Opcodes::CP_r(*this, B);
-                case 0xB9: return Opcodes::CP_r(*this, C);
-                case 0xBA: return Opcodes::CP_r(*this, D);
-                case 0xBB: return Opcodes::CP_r(*this, E);
-                case 0xBC: return Opcodes::CP_r(*this, H);
-                case 0xBD: return Opcodes::CP_r(*this, L);
-                case 0xBE: return Opcodes::CP_ptr_HL(*this);
-                case 0xBF: return Opcodes::CP_r(*this, A);
-                case 0xC0: return Opcodes::RET_cc(*this, IS_NOT_ZERO);
-                case 0xC1: return Opcodes::POP_rr(*this, BC);
-                case 0xC2: return Opcodes::JP_cc_u16(*this, IS_NOT_ZERO);
-                case 0xC3: return Opcodes::JP_u16(*this);
-                case 0xC4: return Opcodes::CALL_cc_u16(*this, IS_NOT_ZERO);
-                case 0xC5: return Opcodes::PUSH_rr(*this, BC);
-                case 0xC6: return Opcodes::ADD_u8(*this);
-                case 0xC7: return Opcodes::RST_n(*this, 0);
-                case 0xC8: return Opcodes::RET_cc(*this, IS_ZERO);
-                case 0xC9: return Opcodes::RET(*this);
-                case 0xCA: return Opcodes::JP_cc_u16(*this, IS_ZERO);
-                case 0xCC: return Opcodes::CALL_cc_u16(*this, IS_ZERO);
-                case 0xCD: return Opcodes::CALL_u16(*this);
-                case 0xCE: return Opcodes::ADC_u8(*this);
-                case 0xCF: return Opcodes::RST_n(*this, 1);
-                case 0xD0: return Opcodes::RET_cc(*this, IS_NOT_CARRY);
-                case 0xD1: return Opcodes::POP_rr(*this, DE);
-                case 0xD2: return Opcodes::JP_cc_u16(*this, IS_NOT_CARRY);
-                case 0xD4: return Opcodes::CALL_cc_u16(*this, IS_NOT_CARRY);
-                case 0xD5: return Opcodes::PUSH_rr(*this, DE);
-                case 0xD6: return Opcodes::SUB_u8(*this);
-                case 0xD7: return Opcodes::RST_n(*this, 2);
-                case 0xD8: return Opcodes::RET_cc(*this, IS_CARRY);
-                case 0xD9: return Opcodes::RETI(*this);
-                case 0xDA: return Opcodes::JP_cc_u16(*this, IS_CARRY);
-                case 0xDC: return Opcodes::CALL_cc_u16(*this, IS_CARRY);
-                case 0xDE: return Opcodes::SBC_u8(*this);
-                case 0xDF: return Opcodes::RST_n(*this, 3);
-                case 0xE0: return Opcodes::LDH_ptr_u8_A(*this);
-                case 0xE1: return Opcodes::POP_rr(*this, HL);
-                case 0xE2: return Opcodes::LDH_ptr_C_A(*this);
-                case 0xE5: return Opcodes::PUSH_rr(*this, HL);
-                case 0xE6: return Opcodes::AND_u8(*this);
-                case 0xE7: return Opcodes::RST_n(*this, 4);
-                case 0xE8: return Opcodes::ADD_SP_s8(*this);
-                case 0xE9: return Opcodes::JP_HL(*this);
-                case 0xEA: return Opcodes::LD_ptr_u16_A(*this);
-                case 0xEE: return Opcodes::XOR_u8(*this);
-                case 0xEF: return Opcodes::RST_n(*this, 5);
-                case 0xF0: return Opcodes::LDH_A_ptr_u8(*this);
-                case 0xF1: return Opcodes::POP_rr(*this, AF);
-                case 0xF2: return Opcodes::LDH_A_ptr_C(*this);
-                case 0xF3: return Opcodes::DI(*this);
-                case 0xF5: return Opcodes::PUSH_rr(*this, AF);
-                case 0xF6: return Opcodes::OR_u8(*this);
-                case 0xF7: return Opcodes::RST_n(*this, 6);
-                case 0xF8: return Opcodes::LD_HL_SP_s8(*this);
-                case 0xF9: return Opcodes::LD_SP_HL(*this);
-                case 0xFA: return Opcodes::LD_A_ptr_u16(*this);
-                case 0xFB: return Opcodes::EI(*this);
-                case 0xFE: return Opcodes::CP_u8(*this);
-                case 0xFF: return Opcodes::RST_n(*this, 7);
-                default: return 0;
-            }
+
+    // Runs a pair of instructions from the superinstruction table exactly as though they were run one at a time
+    template <int first, int second>
+    int CPU::execute_superinstruction(CPU& cpu) {
+        static_assert(OpcodeProfiler::can_fuse(first, second), "The superinstruction table contains a pair which can't be fused");
+        int ticks = execute_opcode<first>(cpu);
+        cpu.program_counter += second >= 0x100 ? 2 : 1;
+        return ticks + execute_opcode<second>(cpu);
+    }
+
+
+    // The fused handlers are generated from the table written by the opcode profiler
+    const std::vector<CPU::Superinstruction> CPU::superinstructions = {
+        #define SUPERINSTRUCTION(first, second) {first, second, &execute_superinstruction<first, second>},
+        #include "superinstruction_table.inc"
+        #undef SUPERINSTRUCTION
+    };
+
+
+    CPU::OpcodeHandler CPU::find_superinstruction(int first, int second) {
+        for (auto& superinstruction : superinstructions) {
+            if (superinstruction.first == first && superinstruction.second == second) return superinstruction.handler;
         }
+
+        return nullptr;
     }
 }
\ No newline at end of file
@@ -4,7 +4,13 @@
 #include <cstdint>
 #include <string>
 #include <vector>
+#include <array>
+#include <utility>
 #include "mmu.hpp"
+#include "block_cache.hpp"
+#include "jit.hpp"
+#include "idle_loop_detector.hpp"
+#include "opcode_profiler.hpp"
 
 
 typedef unsigned char U8;
@@ -19,10 +25,35 @@ namespace Hardware {
     public:
         enum Flag {ZERO, SUB, HALF_CARRY, CARRY};
         enum FlagCondition {IS_ZERO, IS_NOT_ZERO, IS_CARRY, IS_NOT_CARRY};
-        enum CombinedRegister {AF, BC, DE, HL};
-        U8 A, B, C, D, E, F, H, L;
+        enum FlagOperation {NO_OPERATION, ADD_OPERATION, ADC_OPERATION, SUB_OPERATION, SBC_OPERATION, INC_OPERATION, DEC_OPERATION, AND_OPERATION, LOGICAL_OPERATION};
+        typedef int (*OpcodeHandler)(CPU& cpu);
+
+        struct Superinstruction {
+            int first;
+            int second;
+            OpcodeHandler handler;
+        };
+
+        // Each register pair is a 16-bit value aliased by its two 8-bit registers, ordered to match the host's byte order
+        // AF must only be accessed through read_AF and write_AF so that the lazy flags are evaluated and the low nibble of F stays 0
+        #if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            union {struct {U8 A, F;}; U16 AF;};
+            union {struct {U8 B, C;}; U16 BC;};
+            union {struct {U8 D, E;}; U16 DE;};
+            union {struct {U8 H, L;}; U16 HL;};
+        #else
+            union {struct {U8 F, A;}; U16 AF;};
+            union {struct {U8 C, B;}; U16 BC;};
+            union {struct {U8 E, D;}; U16 DE;};
+            union {struct {U8 L, H;}; U16 HL;};
+        #endif
+        FlagOperation lazy_flag_operation;
+        U8 lazy_flag_a;
+        U8 lazy_flag_b;
+        bool lazy_flag_carry;
         const int clock_speed;
         int ticks;
+        int last_instruction_count;
         bool is_halted;
         U16 program_counter;
         U16 stack_pointer;
@@ -33,20 +64,50 @@ namespace Hardware {
         bool is_interrupt_master_enabled;
         bool can_enable_interrupts;
         U8 last_opcode;
+        const U8* fetch_window;
+        U16 fetch_window_start;
+        int fetch_window_length;
+        BlockCache block_cache;
+        bool is_block_cache_enabled;
+        JIT jit;
+        bool is_jit_enabled;
+        IdleLoopDetector idle_loop_detector;
+        OpcodeProfiler opcode_profiler;
+        bool are_superinstructions_enabled;
 
         CPU(MMU& _mmu);
         void reset();
         void set_interrupt(U8 interrupt_bit, bool state);
         void handle_interrupts();
+        bool can_service_interrupts();
         void call_interrupt_service_routine(U8 interrupt_bit);
-        int run();
-        U16 read_combined_register(CombinedRegister combined_register);
-        void write_combined_register(CombinedRegister combined_register, U16 u16);
+        bool run_frame(int ticks_per_frame);
+        int run(int max_skipped_ticks);
+        int run_halted(int max_ticks);
+        int get_ticks_until_interrupt(int max_ticks);
+        int get_ticks_before_interrupt(int max_ticks);
+        U16 read_AF();
+        void write_AF(U16 u16);
         void set_flag(Flag flag, bool state);
         bool get_flag(Flag flag);
+        void set_lazy_flags(FlagOperation operation, U8 a, U8 b, bool carry);
+        void evaluate_lazy_flags();
+        bool get_lazy_carry();
         void push_onto_stack(U16 u16);
         U16 pop_off_stack();
+        void map_fetch_window();
         U8 fetch();
+        U16 fetch_u16();
         int execute(U8 opcode);
+        int dispatch(OpcodeHandler handler);
+        #if defined(__GNUC__)
+            int execute_computed_goto(U8 opcode);
+        #endif
+        template <int opcode> static int execute_opcode(CPU& cpu);
+        template <std::size_t... opcodes> static constexpr std::array<OpcodeHandler, 512> generate_opcode_handlers(std::index_sequence<opcodes...>);
+        static const std::array<OpcodeHandler, 512> opcode_handlers;
+        template <int first, int second> static int execute_superinstruction(CPU& cpu);
+        static const std::vector<Superinstruction> superinstructions;
+        static OpcodeHandler find_superinstruction(int first, int second);
     };
 }
@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include "idle_loop_detector.hpp"
+#include "cpu.hpp"
+#include "mmu.hpp"
+#include "timer.hpp"
+#include "cartridge.hpp"
+#include "../Utilities/misc.hpp"
+
+
+namespace Hardware {
+
+    // Spots short loops which do nothing but poll a fixed address, such as waiting on LY or a flag set by the V-blank handler
+    // Once an iteration has run without anything happening which could change the polled value, every following iteration repeats it exactly
+    // These iterations are then skipped all at once, up to the next event which could change the polled value
+    // Detections are kept for each ROM across resets, so loops in ROM are only matched the first time they are run
+    IdleLoopDetector::IdleLoopDetector(CPU& _cpu) :
+        cpu(_cpu),
+        is_enabled(true),
+        is_report_enabled(false) {
+        reset();
+    }
+
+
+    void IdleLoopDetector::reset() {
+        candidate_block = nullptr;
+        candidate_ticks_until_event = 0;
+        total_skips = 0;
+        total_skipped_instructions = 0;
+        total_skipped_ticks = 0;
+    }
+
+
+    // Called at the start of each cached block, returning the ticks skipped or 0 if the block should be run as normal
+    int IdleLoopDetector::run(BlockCache::BasicBlock& block, int max_skipped_ticks) {
+        if (block.idle_loop_state == BlockCache::UNCHECKED) check_block(block);
+
+        if (block.idle_loop_state != BlockCache::IDLE_LOOP) {
+            candidate_block = nullptr;
+            return 0;
+        }
+
+        // The last iteration must have run from the start of this block without an event part way through it
+        int ticks_until_event = get_ticks_until_event(block.idle_loop_address, max_skipped_ticks);
+        bool is_repeating = candidate_block == &block && candidate_ticks_until_event > block.idle_loop_ticks;
+        candidate_block = &block;
+        candidate_ticks_until_event = ticks_until_event;
+        if (!is_repeating) return 0;
+
+        // Only iterations which finish before the event are skipped, so the event still happens part way through an iteration
+        int skipped_iterations = (ticks_until_event - 1) / block.idle_loop_ticks;
+        if (skipped_iterations <= 0) return 0;
+        int skipped_ticks = skipped_iterations * block.idle_loop_ticks;
+        candidate_ticks_until_event -= skipped_ticks;
+        cpu.last_instruction_count = skipped_iterations * block.instructions.size();
+        total_skips++;
+        total_skipped_instructions += cpu.last_instruction_count;
+        total_skipped_ticks += skipped_ticks;
+        return skipped_ticks;
+    }
+
+
+    // Matches a load of A from a fixed address, followed by tests of A, and then a conditional jump back to the load
+    // Nothing else is allowed, so each iteration only changes A and the flags, which both depend only on the polled value
+    void IdleLoopDetector::check_block(BlockCache::BasicBlock& block) {
+        block.idle_loop_state = BlockCache::NOT_IDLE_LOOP;
+        std::map<int, IdleLoop>& rom_loops = detected_loops[get_rom_name()];
+        int location = get_location(block.start_address);
+        auto detected_loop = rom_loops.find(location);
+
+        // Code in ROM can't change, so an earlier detection still holds, while code in RAM is matched again
+        if (detected_loop != rom_loops.end() && block.start_address < 0x8000) {
+            block.idle_loop_state = BlockCache::IDLE_LOOP;
+            block.idle_loop_address = detected_loop->second.polled_address;
+            block.idle_loop_ticks = detected_loop->second.ticks;
+            return;
+        }
+
+        int total_instructions = block.instructions.size();
+        if (total_instructions < 2 || total_instructions > 4) return;
+        U16 address = 0;
+        int ticks = 0;
+
+        for (int i = 0; i < total_instructions; i++) {
+            int offset = block.instructions[i].address - block.start_address;
+            U8 opcode = block.bytes[offset];
+
+            // LDH A, (u8) and LD A, (u16)
+            if (i == 0) {
+                if (opcode == 0xF0) {
+                    address = 0xFF00 | block.bytes[offset + 1];
+                    ticks += 12;
+                }
+
+                else if (opcode == 0xFA) {
+                    address = block.bytes[offset + 1] | block.bytes[offset + 2] << 8;
+                    ticks += 16;
+                }
+
+                else return;
+            }
+
+            // JR cc, s8 and JP cc, u16 back to the start of the block, with their taken ticks
+            else if (i == total_instructions - 1) {
+                U16 target;
+
+                if (opcode == 0x20 || opcode == 0x28 || opcode == 0x30 || opcode == 0x38) {
+                    target = block.end_address + (signed char)block.bytes[offset + 1];
+                    ticks += 12;
+                }
+
+                else if (opcode == 0xC2 || opcode == 0xCA || opcode == 0xD2 || opcode == 0xDA) {
+                    target = block.bytes[offset + 1] | block.bytes[offset + 2] << 8;
+                    ticks += 16;
+                }
+
+                else return;
+
+                if (target != block.start_address) return;
+            }
+
+            // CP u8, AND u8, AND A, OR A and BIT b, A
+            else {
+                switch (opcode) {
+                    case 0xFE: case 0xE6: ticks += 8; break;
+                    case 0xA7: case 0xB7: ticks += 4; break;
+                    case 0xCB: if ((block.bytes[offset + 1] & 0xC7) != 0x47) return; ticks += 8; break;
+                    default: return;
+                }
+            }
+        }
+
+        if (!is_pollable_address(address)) return;
+        block.idle_loop_state = BlockCache::IDLE_LOOP;
+        block.idle_loop_address = address;
+        block.idle_loop_ticks = ticks;
+        rom_loops[location] = {address, ticks};
+    }
+
+
+    // Identifies the ROM by its file name and the global checksum in its header, as homebrew ROMs often leave the title blank
+    std::string IdleLoopDetector::get_rom_name() {
+        Cartridge& cartridge = cpu.mmu.cartridge;
+        if (cartridge.rom == nullptr) return "";
+        std::stringstream name;
+        name << Utilities::get_file_name_from_path(cartridge.file_path) << " (checksum 0x" << std::hex << std::uppercase << std::setfill('0');
+        name << std::setw(4) << (cartridge.rom->data[0x14E] << 8 | cartridge.rom->data[0x14F]) << ")";
+        return name.str();
+    }
+
+
+    // The same address in the switchable ROM bank holds different code in each bank, so the bank is kept above the address
+    int IdleLoopDetector::get_location(U16 address) {
+        if (address >= 0x8000) return address;
+        return cpu.mmu.cartridge.get_rom_bank(address) << 16 | address;
+    }
+
+
+    // Memory can only be changed by the CPU itself, including interrupt handlers
+    // The exception is cartridge RAM on MBC3 cartridges, where the clock registers are mapped and count in real time
+    // Only the I/O registers whose changes are covered by get_ticks_until_event can be polled
+    bool IdleLoopDetector::is_pollable_address(U16 address) {
+        if (address >= 0xA000 && address < 0xC000) return !cpu.mmu.cartridge.does_contain_clock;
+        if (address < 0xFF00 || address >= 0xFF80) return true;
+
+        switch (address) {
+            case 0xFF00: // Joypad - only updated between frames
+            case 0xFF04: // Divider
+            case 0xFF05: // Counter
+            case 0xFF0F: // Interrupt flag
+            case 0xFF41: // LCD status
+            case 0xFF44: // LY
+                return true;
+
+            default: return false;
+        }
+    }
+
+
+    // Interrupts are only raised by the PPU and timer, and LY and the LCD status only change when the PPU switches modes
+    int IdleLoopDetector::get_ticks_until_event(U16 address, int max_ticks) {
+        int ticks_until_event = cpu.get_ticks_until_interrupt(max_ticks);
+        Timer& timer = cpu.mmu.timer;
+        if (address == 0xFF04) ticks_until_event = std::min(ticks_until_event, timer.divider_period - timer.divider_ticks);
+        if (address == 0xFF05 && timer.is_counter_enabled) ticks_until_event = std::min(ticks_until_event, timer.counter_period - timer.counter_ticks);
+        return ticks_until_event;
+    }
+
+
+    std::string IdleLoopDetector::get_report() {
+        std::stringstream report;
+        std::string rom_name = get_rom_name();
+        std::map<int, IdleLoop>& rom_loops = detected_loops[rom_name];
+        report << "Idle loops detected in " << rom_name << ": " << rom_loops.size() << "\n";
+
+        for (auto& [location, idle_loop] : rom_loops) {
+            report << std::hex << std::uppercase << std::setfill('0');
+            report << "    0x" << std::setw(4) << (location & 0xFFFF) << " polling 0x" << std::setw(4) << idle_loop.polled_address;
+            if (location >= 0x10000) report << " in ROM bank " << std::dec << (location >> 16);
+            report << std::dec << "\n";
+        }
+
+        report << "Idle loop skips: " << total_skips << "\n";
+        report << "Skipped instructions: " << total_skipped_instructions << "\n";
+        report << "Skipped emulated time: " << std::fixed << std::setprecision(2) << (double)total_skipped_ticks / cpu.clock_speed << "s\n";
+        return report.str();
+    }
+
+
+    // Only printed when asked for, as a statistic for checking how much emulation time the skipping saves
+    void IdleLoopDetector::print_report() {
+        if (!is_report_enabled || detected_loops[get_rom_name()].empty()) return;
+        std::cout << get_report();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include "block_cache.hpp"
+
+
+typedef unsigned char U8;
+typedef unsigned short U16;
+
+
+namespace Hardware {
+    class CPU;
+
+
+    class IdleLoopDetector {
+    public:
+        struct IdleLoop {
+            U16 polled_address;
+            int ticks;
+        };
+
+        CPU& cpu;
+        bool is_enabled;
+        bool is_report_enabled;
+        BlockCache::BasicBlock* candidate_block;
+        int candidate_ticks_until_event;
+        std::map<std::string, std::map<int, IdleLoop>> detected_loops; // By ROM, and then by the ROM bank and start address of each loop
+        long long total_skips;
+        long long total_skipped_instructions;
+        long long total_skipped_ticks;
+
+        IdleLoopDetector(CPU& _cpu);
+        void reset();
+        int run(BlockCache::BasicBlock& block, int max_skipped_ticks);
+        void check_block(BlockCache::BasicBlock& block);
+        bool is_pollable_address(U16 address);
+        std::string get_rom_name();
+        int get_location(U16 address);
+        int get_ticks_until_event(U16 address, int max_ticks);
+        std::string get_report();
+        void print_report();
+    };
+}
\ No newline at end of file
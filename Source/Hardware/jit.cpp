@@ -0,0 +1,332 @@
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include "jit.hpp"
+#include "cpu.hpp"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define ANTBOY_JIT_X86_64
+#endif
+
+
+namespace Hardware {
+
+    // Translates hot basic blocks from ROM into native x86-64 code
+    // Only the leading run of instructions which touch nothing but the CPU registers is translated (loads, increments, decrements and ALU operations)
+    // As these never access memory, the rest of the system can't observe the instructions running as a single step
+    // Everything else, including all code in RAM, is left to the interpreter
+    // The code buffer is never writable and executable at once - each page is only made executable once its code has been copied in
+    JIT::JIT(CPU& _cpu) :
+        cpu(_cpu),
+        is_available(false),
+        is_differential_testing_enabled(false),
+        hot_block_threshold(16),
+        code_buffer_size(1048576),
+        code_buffer_used(0),
+        code_buffer(nullptr),
+        page_size(4096) {
+
+        // The generated code addresses the registers relative to A, so they must all be within a signed byte of it
+        U8* registers[8] = {&cpu.B, &cpu.C, &cpu.D, &cpu.E, &cpu.H, &cpu.L, nullptr, &cpu.A};
+        for (int i = 0; i < 8; i++) register_offsets[i] = registers[i] == nullptr ? 0 : registers[i] - &cpu.A;
+        flags_offset = &cpu.F - &cpu.A;
+        U16* register_pairs[3] = {&cpu.BC, &cpu.DE, &cpu.HL};
+        for (int i = 0; i < 3; i++) register_pair_offsets[i] = (U8*)register_pairs[i] - &cpu.A;
+
+        #if defined(ANTBOY_JIT_X86_64)
+            #if defined(_WIN32)
+                SYSTEM_INFO system_info;
+                GetSystemInfo(&system_info);
+                page_size = system_info.dwPageSize;
+                code_buffer = (U8*)VirtualAlloc(nullptr, code_buffer_size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+            #else
+                page_size = sysconf(_SC_PAGESIZE);
+                void* memory = mmap(nullptr, code_buffer_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                code_buffer = memory == MAP_FAILED ? nullptr : (U8*)memory;
+            #endif
+
+            is_available = code_buffer != nullptr;
+        #endif
+    }
+
+
+    JIT::~JIT() {
+        if (code_buffer == nullptr) return;
+
+        #if defined(_WIN32)
+            VirtualFree(code_buffer, 0, MEM_RELEASE);
+        #else
+            munmap(code_buffer, code_buffer_size);
+        #endif
+    }
+
+
+    // Compiled code belongs to the blocks in the block cache, so it is discarded alongside them
+    void JIT::reset() {code_buffer_used = 0;}
+
+
+    // Runs the native code for a block, compiling it once it becomes hot
+    // Returns the ticks taken, or 0 if the block must be interpreted instead
+    int JIT::run(BlockCache::BasicBlock& block, int max_ticks) {
+        if (!is_available) return 0;
+
+        if (block.native_code == nullptr) {
+            if (block.is_native_compilation_attempted || block.start_address >= 0x8000) return 0; // RAM blocks could be modified at any time
+            if (++block.execution_count < hot_block_threshold) return 0;
+            compile(block);
+            if (block.native_code == nullptr) return 0;
+        }
+
+        if (block.native_ticks > max_ticks) return 0; // The interpreter runs up to the end of the frame or the next interrupt one instruction at a time instead
+
+        // The native code works on the F register directly, so any pending flags must be calculated first
+        cpu.evaluate_lazy_flags();
+        if (is_differential_testing_enabled) return run_differential(block);
+        block.native_code(&cpu.A);
+        cpu.program_counter = block.native_end_address;
+        cpu.block_cache.active_instruction_index = block.native_instructions;
+        return block.native_ticks;
+    }
+
+
+    // Runs the native code and then the interpreter over the same instructions from the same starting registers
+    // The interpreter's results are kept, and a block is never run natively again once the two disagree
+    int JIT::run_differential(BlockCache::BasicBlock& block) {
+        U8* registers[8] = {&cpu.A, &cpu.F, &cpu.B, &cpu.C, &cpu.D, &cpu.E, &cpu.H, &cpu.L};
+        U8 starting_registers[8];
+        U8 native_registers[8];
+        for (int i = 0; i < 8; i++) starting_registers[i] = *registers[i];
+        block.native_code(&cpu.A);
+        for (int i = 0; i < 8; i++) native_registers[i] = *registers[i];
+        for (int i = 0; i < 8; i++) *registers[i] = starting_registers[i];
+        int ticks = 0;
+
+        for (int i = 0; i < block.native_instructions; i++) {
+            cpu.program_counter += block.instructions[i].opcode_length;
+            ticks += block.instructions[i].handler(cpu);
+        }
+
+        cpu.block_cache.active_instruction_index = block.native_instructions;
+        cpu.evaluate_lazy_flags();
+        bool is_matching = cpu.program_counter == block.native_end_address && ticks == block.native_ticks;
+        for (int i = 0; i < 8; i++) is_matching = is_matching && *registers[i] == native_registers[i];
+        if (is_matching) return ticks;
+
+        std::cerr << "Error: JIT mismatch in block at 0x" << std::hex << std::uppercase << std::setfill('0') << std::setw(4) << block.start_address;
+        std::cerr << std::dec << ", falling back to the interpreter" << std::endl;
+        block.native_code = nullptr;
+        return ticks;
+    }
+
+
+    void JIT::compile(BlockCache::BasicBlock& block) {
+        block.is_native_compilation_attempted = true;
+        code.clear();
+
+        // Prologue - the pointer to the registers is held in r9 for the rest of the block
+        #if defined(_WIN32)
+            emit({0x49, 0x89, 0xC9}); // mov r9, rcx
+        #else
+            emit({0x49, 0x89, 0xF9}); // mov r9, rdi
+        #endif
+
+        int prologue_size = code.size();
+        int ticks = 0;
+        int total_instructions = 0;
+
+        for (auto& instruction : block.instructions) {
+            int offset = instruction.address - block.start_address;
+            U8 opcode = block.bytes[offset];
+            U8 operand = offset + 1 < (int)block.bytes.size() ? block.bytes[offset + 1] : 0;
+            if (!emit_instruction(opcode, operand, ticks)) break;
+            total_instructions++;
+        }
+
+        // A single instruction isn't worth leaving the interpreter for
+        if (total_instructions < 2 || (int)code.size() == prologue_size) return;
+        emit({0xC3}); // ret
+        if (code_buffer_used + (int)code.size() > code_buffer_size) return;
+        if (!set_code_executable(code_buffer_used, code.size(), false)) return;
+        std::memcpy(code_buffer + code_buffer_used, code.data(), code.size());
+
+        // Systems which refuse to make memory executable leave everything to the interpreter
+        if (!set_code_executable(code_buffer_used, code.size(), true)) {
+            std::cerr << "Error: Unable to make the JIT's code executable, falling back to the interpreter" << std::endl;
+            is_available = false;
+            return;
+        }
+
+        block.native_code = (BlockCache::NativeCode)(code_buffer + code_buffer_used);
+        block.native_instructions = total_instructions;
+        block.native_ticks = ticks;
+        block.native_end_address = total_instructions < (int)block.instructions.size() ? block.instructions[total_instructions].address : block.end_address;
+        code_buffer_used += code.size();
+    }
+
+
+    // Switches the pages holding part of the code buffer between read-write and read-execute
+    // The first page may already hold earlier blocks, which is safe as they are never run while a block is being compiled
+    bool JIT::set_code_executable(int offset, int size, bool is_executable) {
+        int page_offset = offset / page_size * page_size;
+
+        #if defined(_WIN32)
+            DWORD previous_protection;
+            return VirtualProtect(code_buffer + page_offset, offset + size - page_offset, is_executable ? PAGE_EXECUTE_READ : PAGE_READWRITE, &previous_protection);
+        #else
+            return mprotect(code_buffer + page_offset, offset + size - page_offset, is_executable ? PROT_READ | PROT_EXEC : PROT_READ | PROT_WRITE) == 0;
+        #endif
+    }
+
+
+    // Emits the native code for a single instruction, returning false if the instruction can't be translated
+    // Register indexes follow the opcode encoding - B, C, D, E, H, L, (HL), A
+    bool JIT::emit_instruction(U8 opcode, U8 operand, int& ticks) {
+        int destination = (opcode >> 3) & 7;
+        int source = opcode & 7;
+
+        if (opcode == 0x00) {
+            ticks += 4;
+            return true;
+        }
+
+        // LD r, r
+        if (opcode >= 0x40 && opcode < 0x80) {
+            if (destination == 6 || source == 6) return false;
+
+            if (destination != source) {
+                emit({0x41, 0x8A, 0x41, register_offsets[source]}); // mov al, [r9 + source]
+                emit({0x41, 0x88, 0x41, register_offsets[destination]}); // mov [r9 + destination], al
+            }
+
+            ticks += 4;
+            return true;
+        }
+
+        // ALU A, r
+        if (opcode >= 0x80 && opcode < 0xC0) {
+            if (source == 6) return false;
+            emit_alu(destination, false, register_offsets[source]);
+            ticks += 4;
+            return true;
+        }
+
+        // ALU A, u8
+        if (opcode >= 0xC0 && (opcode & 7) == 6) {
+            emit_alu(destination, true, operand);
+            ticks += 8;
+            return true;
+        }
+
+        if (opcode < 0x40) {
+
+            // LD r, u8
+            if (source == 6 && destination != 6) {
+                emit({0x41, 0xC6, 0x41, register_offsets[destination], operand}); // mov byte [r9 + destination], u8
+                ticks += 8;
+                return true;
+            }
+
+            // INC r and DEC r
+            if ((source == 4 || source == 5) && destination != 6) {
+                emit({0x41, 0xFE, (U8)(source == 4 ? 0x41 : 0x49), register_offsets[destination]}); // inc/dec byte [r9 + destination]
+                emit_flags(INCREMENT, source == 5);
+                ticks += 4;
+                return true;
+            }
+
+            // INC rr and DEC rr (excluding SP)
+            if ((source == 3) && destination < 6) {
+                emit_step_register_pair(destination >> 1, destination % 2 == 0);
+                ticks += 8;
+                return true;
+            }
+        }
+
+        switch (opcode) {
+
+            // CPL
+            case 0x2F:
+                emit({0x41, 0x8A, 0x41, register_offsets[7]}); // mov al, [r9 + A]
+                emit({0xF6, 0xD0}); // not al
+                emit({0x41, 0x88, 0x41, register_offsets[7]}); // mov [r9 + A], al
+                emit({0x41, 0x80, 0x49, flags_offset, 0x60}); // or byte [r9 + F], SUB | HALF_CARRY
+                ticks += 4;
+                return true;
+
+            // SCF and CCF
+            case 0x37:
+            case 0x3F:
+                emit({0x41, 0x8A, 0x41, flags_offset}); // mov al, [r9 + F]
+                if (opcode == 0x37) emit({0x24, 0x80, 0x0C, 0x10}); // and al, ZERO; or al, CARRY
+                else emit({0x24, 0x90, 0x34, 0x10}); // and al, ZERO | CARRY; xor al, CARRY
+                emit({0x41, 0x88, 0x41, flags_offset}); // mov [r9 + F], al
+                ticks += 4;
+                return true;
+
+            default: return false;
+        }
+    }
+
+
+    void JIT::emit(std::initializer_list<U8> bytes) {code.insert(code.end(), bytes);}
+
+
+    // Emits ADD, ADC, SUB, SBC, AND, XOR, OR or CP on A, where the operation index follows the opcode encoding
+    // x86 computes the same half carry and carry for 8-bit additions and subtractions as the Gameboy does, so the native flags are reused
+    void JIT::emit_alu(U8 operation, bool is_immediate, U8 source) {
+        static const U8 register_encodings[8] = {0x02, 0x12, 0x2A, 0x1A, 0x22, 0x32, 0x0A, 0x3A};
+        static const U8 immediate_encodings[8] = {0x04, 0x14, 0x2C, 0x1C, 0x24, 0x34, 0x0C, 0x3C};
+        emit({0x41, 0x8A, 0x41, register_offsets[7]}); // mov al, [r9 + A]
+
+        // ADC and SBC take their carry in from the carry flag
+        if (operation == 1 || operation == 3) {
+            emit({0x41, 0x8A, 0x49, flags_offset}); // mov cl, [r9 + F]
+            emit({0x0F, 0xBA, 0xE1, 0x04}); // bt ecx, 4
+        }
+
+        if (is_immediate) emit({immediate_encodings[operation], source}); // op al, u8
+        else emit({0x41, register_encodings[operation], 0x41, source}); // op al, [r9 + source]
+        if (operation != 7) emit({0x41, 0x88, 0x41, register_offsets[7]}); // mov [r9 + A], al (CP discards the result)
+
+        if (operation == 4) emit_flags(AND, false);
+        else if (operation >= 5 && operation <= 6) emit_flags(LOGICAL, false);
+        else emit_flags(ARITHMETIC, operation == 2 || operation == 3 || operation == 7);
+    }
+
+
+    // Converts the x86 flags of the last operation into the Gameboy flags register
+    void JIT::emit_flags(FlagBehaviour flag_behaviour, bool is_subtraction) {
+        emit({0x9F}); // lahf
+        emit({0x0F, 0xB6, 0xCC}); // movzx ecx, ah
+        emit({0x89, 0xCA, 0x83, 0xE2, 0x40, 0xD1, 0xE2}); // ZERO - mov edx, ecx; and edx, 0x40; shl edx, 1
+
+        if (flag_behaviour == ARITHMETIC || flag_behaviour == INCREMENT) {
+            emit({0x89, 0xC8, 0x83, 0xE0, 0x10, 0xD1, 0xE0, 0x09, 0xC2}); // HALF_CARRY - mov eax, ecx; and eax, 0x10; shl eax, 1; or edx, eax
+        }
+
+        if (flag_behaviour == ARITHMETIC) emit({0x83, 0xE1, 0x01, 0xC1, 0xE1, 0x04, 0x09, 0xCA}); // CARRY - and ecx, 1; shl ecx, 4; or edx, ecx
+
+        // Increments and decrements leave the carry flag untouched
+        if (flag_behaviour == INCREMENT) {
+            emit({0x41, 0x8A, 0x49, flags_offset}); // mov cl, [r9 + F]
+            emit({0x80, 0xE1, 0x10, 0x08, 0xCA}); // and cl, CARRY; or dl, cl
+        }
+
+        if (flag_behaviour == AND) emit({0x80, 0xCA, 0x20}); // or dl, HALF_CARRY
+        if (is_subtraction) emit({0x80, 0xCA, 0x40}); // or dl, SUB
+        emit({0x41, 0x88, 0x51, flags_offset}); // mov [r9 + F], dl
+    }
+
+
+    // Register pairs are BC, DE and HL, which are stored as little-endian 16-bit values on x86-64
+    void JIT::emit_step_register_pair(int register_pair, bool is_increment) {
+        emit({0x66, 0x41, 0xFF, (U8)(is_increment ? 0x41 : 0x49), register_pair_offsets[register_pair]}); // inc/dec word [r9 + pair]
+    }
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+
+#include <cstdint>
+#include <vector>
+#include <array>
+#include "block_cache.hpp"
+
+
+typedef unsigned char U8;
+typedef unsigned short U16;
+
+
+namespace Hardware {
+    class CPU;
+
+
+    class JIT {
+    public:
+        enum FlagBehaviour {ARITHMETIC, INCREMENT, AND, LOGICAL};
+        CPU& cpu;
+        bool is_available;
+        bool is_differential_testing_enabled;
+        int hot_block_threshold;
+        int code_buffer_size;
+        int code_buffer_used;
+        U8* code_buffer;
+        int page_size;
+        std::vector<U8> code;
+        std::array<U8, 8> register_offsets;
+        U8 flags_offset;
+        std::array<U8, 3> register_pair_offsets;
+
+        JIT(CPU& _cpu);
+        ~JIT();
+        void reset();
+        int run(BlockCache::BasicBlock& block, int max_ticks);
+        int run_differential(BlockCache::BasicBlock& block);
+        void compile(BlockCache::BasicBlock& block);
+        bool set_code_executable(int offset, int size, bool is_executable);
+        bool emit_instruction(U8 opcode, U8 operand, int& ticks);
+        void emit(std::initializer_list<U8> bytes);
+        void emit_alu(U8 operation, bool is_immediate, U8 source);
+        void emit_flags(FlagBehaviour flag_behaviour, bool is_subtraction);
+        void emit_step_register_pair(int register_pair, bool is_increment);
+    };
+}
\ No newline at end of file
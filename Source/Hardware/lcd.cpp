@@ -26,6 +26,9 @@ namespace Hardware {
     void LCD::transfer_pixel(int x, int y, U8 pixel) {frame_buffers.back()[y * width + x] = pixel;}
 
 
+    U8* LCD::get_scanline(int y) {return &frame_buffers.back()[y * width];}
+
+
     void LCD::update_frame_buffers() {
         frame_buffers.erase(frame_buffers.begin()); // Pops the oldest frame from the front
         frame_buffers.emplace_back(); // Pushes a new frame onto the back
@@ -36,6 +36,7 @@ namespace Hardware {
         LCD();
         void reset();
         void transfer_pixel(int x, int y, U8 pixel);
+        U8* get_scanline(int y);
         void update_frame_buffers();
         void display(sf::RenderWindow& window, std::shared_ptr<std::array<sf::Color, 4>> palette);
         void scale_pixel(int pixel_index, Utilities::Vector pixel_position, sf::Color pixel_color);
@@ -1,4 +1,6 @@
 #include "mbc.hpp"
+#include "timer.hpp"
+#include "cpu.hpp"
 #include "../Utilities/misc.hpp"
 
 
@@ -10,13 +12,15 @@ namespace Hardware {
         is_ram_enabled(false),
         is_rom_bank_mode(true),
         rom_bank(1),
-        ram_bank(0) {}
+        ram_bank(0),
+        total_rom_banks(2) {}
 
 
     void MBC::write(U16 address, U8 u8) {}
 
 
-    void MBC::modify_rom_bank(U16 address, U8& temporary_rom_bank) {}
+    // The operation (rom bank mod total banks) is performed because bank numbers are wrapped if they exceed the total number of banks
+    int MBC::get_rom_bank(U16 address) {return address < 0x4000 ? 0 : rom_bank % total_rom_banks;}
 
 
     MBC1::MBC1() : MBC(1) {}
@@ -40,10 +44,13 @@ namespace Hardware {
     }
 
 
-    void MBC1::modify_rom_bank(U16 address, U8& temporary_rom_bank) {
-        if (is_rom_bank_mode || total_rom_banks < 32) return;
+    // In RAM banking mode the RAM bank register also supplies bits 5 and 6 of the ROM bank, including for bank zero
+    int MBC1::get_rom_bank(U16 address) {
+        U8 temporary_rom_bank = MBC::get_rom_bank(address);
+        if (is_rom_bank_mode || total_rom_banks < 32) return temporary_rom_bank;
         if (total_rom_banks == 64 || total_rom_banks == 128) Utilities::set_bit_u8(temporary_rom_bank, 5, Utilities::get_bit_u8(ram_bank, 0));
         if (total_rom_banks == 128) Utilities::set_bit_u8(temporary_rom_bank, 6, Utilities::get_bit_u8(ram_bank, 1));
+        return temporary_rom_bank;
     }
 
 
@@ -56,4 +63,92 @@ namespace Hardware {
         else is_ram_enabled = (u8 & 0xF) == 0xA;
         if (rom_bank == 0) rom_bank++;
     }
+
+
+    // The real time clock isn't ticked, instead its time is worked out from the emulated time which has passed whenever it is latched or written
+    // clock_seconds holds the clock's time at clock_base_ticks, as the total seconds counted by the seconds, minutes, hours and days registers
+    MBC3::MBC3(Timer* _timer) :
+        MBC(3),
+        timer(_timer),
+        is_clock_halted(false),
+        has_day_counter_overflowed(false),
+        latch_state(0xFF),
+        clock_seconds(0),
+        clock_base_ticks(_timer == nullptr ? 0 : _timer->total_ticks),
+        latched_clock_registers({0, 0, 0, 0, 0}) {}
+
+
+    void MBC3::write(U16 address, U8 u8) {
+        if (address < 0x2000) is_ram_enabled = (u8 & 0xF) == 0xA; // Enables/disables RAM and the clock registers
+
+        else if (address < 0x4000) {
+            rom_bank = u8 & 0x7F;
+            if (rom_bank == 0) rom_bank++;
+        }
+
+        else if (address < 0x6000) ram_bank = u8 & 0xF; // RAM banks 0-3, or clock registers 8-C
+
+        else if (address < 0x8000) { // Writing 0 then 1 latches the clock registers
+            if (latch_state == 0 && u8 == 1) {
+                update_clock();
+                latched_clock_registers = get_clock_registers();
+            }
+
+            latch_state = u8;
+        }
+    }
+
+
+    // Moves the whole seconds which have passed since clock_base_ticks into clock_seconds, keeping the part of a second left over
+    // The day counter is 9 bits, so the clock wraps after 512 days and sets the day counter carry
+    void MBC3::update_clock() {
+        if (is_clock_halted) return;
+        unsigned long long elapsed_seconds = (timer->total_ticks - clock_base_ticks) / timer->cpu.clock_speed;
+        clock_seconds += elapsed_seconds;
+        clock_base_ticks += elapsed_seconds * timer->cpu.clock_speed;
+        if (clock_seconds < 512 * 86400) return;
+        clock_seconds %= 512 * 86400;
+        has_day_counter_overflowed = true;
+    }
+
+
+    // Seconds, minutes, hours, the lower 8 bits of the day counter, then bit 8 of the day counter with the halt and carry flags
+    std::array<U8, 5> MBC3::get_clock_registers() {
+        int days = clock_seconds / 86400;
+        U8 day_high = (days >> 8) | (U8)is_clock_halted << 6 | (U8)has_day_counter_overflowed << 7;
+        return {(U8)(clock_seconds % 60), (U8)(clock_seconds / 60 % 60), (U8)(clock_seconds / 3600 % 24), (U8)(days & 0xFF), day_high};
+    }
+
+
+    void MBC3::set_clock_registers(std::array<U8, 5> clock_registers) {
+        int days = (clock_registers[4] & 1) << 8 | clock_registers[3];
+        clock_seconds = (clock_registers[0] & 0x3F) + (clock_registers[1] & 0x3F) * 60 + (clock_registers[2] & 0x1F) * 3600 + days * 86400LL;
+        is_clock_halted = Utilities::get_bit_u8(clock_registers[4], 6);
+        has_day_counter_overflowed = Utilities::get_bit_u8(clock_registers[4], 7);
+        clock_base_ticks = timer->total_ticks; // Writing to the clock also restarts the current second
+    }
+
+
+    // Reads return the latched registers, so the time can't change part way through being read
+    U8 MBC3::read_clock() {return latched_clock_registers[ram_bank - 8];}
+
+
+    void MBC3::write_clock(U8 u8) {
+        update_clock();
+        std::array<U8, 5> clock_registers = get_clock_registers();
+        clock_registers[ram_bank - 8] = u8;
+        set_clock_registers(clock_registers);
+    }
+
+
+    // Supports up to 8 MB of ROM through a 9-bit ROM bank, and 128 KB of RAM
+    MBC5::MBC5() : MBC(5) {}
+
+
+    void MBC5::write(U16 address, U8 u8) {
+        if (address < 0x2000) is_ram_enabled = u8 == 0xA;
+        else if (address < 0x3000) rom_bank = (rom_bank & 0x100) | u8; // Lower 8 bits of the ROM bank, unlike the other MBCs bank 0 can be selected
+        else if (address < 0x4000) rom_bank = (u8 & 1) << 8 | (rom_bank & 0xFF); // Bit 8 of the ROM bank
+        else if (address < 0x6000) ram_bank = u8 & 0xF;
+    }
 }
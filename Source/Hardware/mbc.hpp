@@ -1,3 +1,7 @@
+#pragma once
+
+
+#include <array>
 
 
 typedef unsigned char U8;
@@ -5,6 +9,9 @@ typedef unsigned short U16;
 
 
 namespace Hardware {
+    class Timer;
+
+
     class MBC {
     public:
         bool is_ram_enabled;
@@ -14,23 +21,50 @@ namespace Hardware {
         int ram_bank;
         int total_rom_banks;
 
-        MBC(int _type);
-        virtual void write(U16 address, U8 u8);
-        virtual void modify_rom_bank(U16 address, U8& temporary_rom_bank);
+        MBC(int _type = 0);
+        void write(U16 address, U8 u8);
+        int get_rom_bank(U16 address);
     };
 
 
     class MBC1 : public MBC {
     public:
         MBC1();
-        void write(U16 address, U8 u8) override;
-        void modify_rom_bank(U16 address, U8& temporary_rom_bank);
+        void write(U16 address, U8 u8);
+        int get_rom_bank(U16 address);
     };
 
 
     class MBC2 : public MBC {
     public:
         MBC2();
-        void write(U16 address, U8 u8) override;
+        void write(U16 address, U8 u8);
+    };
+
+
+    class MBC3 : public MBC {
+    public:
+        Timer* timer;
+        bool is_clock_halted;
+        bool has_day_counter_overflowed;
+        U8 latch_state;
+        long long clock_seconds;
+        unsigned long long clock_base_ticks;
+        std::array<U8, 5> latched_clock_registers;
+
+        MBC3(Timer* _timer = nullptr);
+        void write(U16 address, U8 u8);
+        void update_clock();
+        std::array<U8, 5> get_clock_registers();
+        void set_clock_registers(std::array<U8, 5> clock_registers);
+        U8 read_clock();
+        void write_clock(U8 u8);
+    };
+
+
+    class MBC5 : public MBC {
+    public:
+        MBC5();
+        void write(U16 address, U8 u8);
     };
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include <memory>
 #include <cstring>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include "mmu.hpp"
@@ -16,9 +17,15 @@ namespace Hardware {
         cartridge(_cartridge),
         joypad(_joypad),
         timer(_timer),
+        is_bootstrap_enabled(false),
+        is_timed_dma_enabled(false),
         exe_path(_exe_path),
         work_ram(std::make_unique<U8[]>(8192)),
-        high_ram(std::make_unique<U8[]>(127)) {
+        high_ram(std::make_unique<U8[]>(127)),
+        watchpoints(*this),
+        bus_tracer(*this) {
+        read_pages.fill(nullptr);
+        write_pages.fill(nullptr);
         load_bootstrap();
     }
 
@@ -26,6 +33,11 @@ namespace Hardware {
     void MMU::reset() {
         std::memset(work_ram.get(), 0, 8192);
         std::memset(high_ram.get(), 0, 127);
+        is_dma_active = false;
+        dma_ticks = 0;
+        dma_bytes_copied = 0;
+        watchpoints.reset();
+        map_pages();
     }
 
 
@@ -36,13 +48,97 @@ namespace Hardware {
     }
 
 
+    void MMU::set_bootstrap_enabled(bool state) {
+        is_bootstrap_enabled = state;
+        map_pages();
+    }
+
+
+    // Each 256 byte page of the address space which is plain memory is mapped to a direct pointer for reading and/or writing
+    // Pages without a pointer (cartridge RAM, echo RAM, OAM, I/O and high RAM) are left to the handlers
+    // ROM pages are only mapped by the first read through them, as the cartridge may not have been inserted yet
+    void MMU::map_pages() {
+        cpu.fetch_window_length = 0; // The CPU's fetch window may point into a page which is being remapped
+        are_rom_pages_mapped = false;
+        read_pages.fill(nullptr);
+        write_pages.fill(nullptr);
+        if (is_bootstrap_enabled) read_pages[0] = bootstrap;
+
+        // Writes to the tile data go through the PPU so that its decoded tiles are kept up to date
+        for (int page = 0x80; page < 0xA0; page++) {
+            read_pages[page] = &ppu.video_ram[(page - 0x80) << 8];
+            if (page >= 0x98) write_pages[page] = &ppu.video_ram[(page - 0x80) << 8];
+        }
+
+        for (int page = 0xC0; page < 0xE0; page++) {
+            read_pages[page] = &work_ram[(page - 0xC0) << 8];
+            map_work_ram_page(page);
+        }
+
+        unmap_handled_pages();
+    }
+
+
+    // Must be called whenever the MBC may have switched ROM banks
+    void MMU::map_rom_pages() {
+        cpu.fetch_window_length = 0;
+        for (int page = 0; page < 0x40; page++) read_pages[page] = cartridge.rom_bank_0_base + (page << 8);
+        for (int page = 0x40; page < 0x80; page++) read_pages[page] = cartridge.switchable_rom_bank_base + ((page - 0x40) << 8);
+        if (is_bootstrap_enabled) read_pages[0] = bootstrap;
+        are_rom_pages_mapped = true;
+        unmap_handled_pages();
+    }
+
+
+    // Work RAM pages containing cached code aren't mapped for writing, so that writes to them go through the handler and invalidate the code
+    void MMU::map_work_ram_page(U8 page) {
+        if (page < 0xC0 || page >= 0xE0) return;
+        bool is_handled = cpu.block_cache.is_ram_page_cached[page] || watchpoints.watched_pages[Watchpoints::WRITE][page] > 0 || bus_tracer.is_recording;
+        write_pages[page] = is_handled ? nullptr : &work_ram[(page - 0xC0) << 8];
+    }
+
+
+    // Pages containing a watched address are left to the handlers, so that the rest of memory is accessed at full speed
+    // Every page is left to the handlers while the bus is being traced
+    void MMU::unmap_handled_pages() {
+        if (bus_tracer.is_recording) {
+            read_pages.fill(nullptr);
+            write_pages.fill(nullptr);
+            return;
+        }
+
+        if (watchpoints.total_watchpoints == 0) return;
+
+        for (int page = 0; page < 256; page++) {
+            if (watchpoints.watched_pages[Watchpoints::READ][page] > 0) read_pages[page] = nullptr;
+            if (watchpoints.watched_pages[Watchpoints::WRITE][page] > 0) write_pages[page] = nullptr;
+        }
+    }
+
+
     U8 MMU::read_u8(U16 address) {
+        const U8* page = read_pages[address >> 8];
+        if (page != nullptr) return page[address & 0xFF];
+        U8 u8 = handle_read_u8(address);
+        if (bus_tracer.is_recording) bus_tracer.record(address, u8, false, BusTracer::FROM_CPU);
+        if (watchpoints.watched_pages[Watchpoints::READ][address >> 8] > 0) watchpoints.check_access(Watchpoints::READ, address, u8);
+        return u8;
+    }
+
+
+    U8 MMU::handle_read_u8(U16 address) {
         // Initialially I used a single array to store the entire Gameboy memory map,
         // however realised that it is much more optimal, readable and convenient to
         // map memory address to different regions/components of the Gameboy instead.
 
+        if (is_dma_active && (address < 0xFF80 || address == 0xFFFF)) return 0xFF; // The CPU can only access high RAM during a timed OAM DMA
         if (is_bootstrap_enabled && address < 0x100) return bootstrap[address]; // Bootstrap interception
-        if (address < 0x8000) return cartridge.read_rom(address); // Cartridge ROM access
+
+        if (address < 0x8000) {
+            if (!are_rom_pages_mapped) map_rom_pages();
+            return cartridge.read_rom(address); // Cartridge ROM access
+        }
+
         if (address < 0xA000) return ppu.video_ram[address - 0x8000]; // Video RAM access
         if (address < 0xC000) return cartridge.read_ram(address); // Cartridge RAM access
         if (address < 0xE000) return work_ram[address - 0xC000]; // Work RAM access
@@ -64,11 +160,36 @@ namespace Hardware {
 
 
     void MMU::write_u8(U16 address, U8 u8) {
-        if (address < 0x8000) cartridge.mbc->write(address, u8);
-        else if (address < 0xA000) ppu.video_ram[address - 0x8000] = u8;
+        U8* page = write_pages[address >> 8];
+
+        if (page != nullptr) {
+            page[address & 0xFF] = u8;
+            return;
+        }
+
+        if (bus_tracer.is_recording) bus_tracer.record(address, u8, true, BusTracer::FROM_CPU);
+        if (watchpoints.watched_pages[Watchpoints::WRITE][address >> 8] > 0) watchpoints.check_access(Watchpoints::WRITE, address, u8);
+        handle_write_u8(address, u8);
+    }
+
+
+    void MMU::handle_write_u8(U16 address, U8 u8) {
+        if (is_dma_active && (address < 0xFF80 || address == 0xFFFF)) return;
+
+        if (address < 0x8000) {
+            if (!cartridge.write_rom(address, u8)) return;
+            cpu.block_cache.select_rom_block_sets(); // The write may have switched ROM banks
+            map_rom_pages();
+        }
+
+        else if (address < 0xA000) ppu.write_video_ram(address, u8);
         else if (address < 0xC000) cartridge.write_ram(address, u8);
-        else if (address < 0xE000) work_ram[address - 0xC000] = u8;
-        else if (address >=  0xFE00 && address < 0xFEA0) ppu.oam[address - 0xFE00] = u8;
+        else if (address < 0xE000) {
+            work_ram[address - 0xC000] = u8;
+            if (cpu.block_cache.is_ram_page_cached[address >> 8]) cpu.block_cache.invalidate_ram_page(address >> 8); // Self-modifying code
+        }
+
+        else if (address >=  0xFE00 && address < 0xFEA0) ppu.write_oam(address, u8);
         else if (address == 0xFF00) joypad.joypad = u8 & 0xF0;
         else if (address >= 0xFF04 && address < 0xFF08) timer.write(address, u8);
         else if (address == 0xFF0F) cpu.interrupt_flag = u8;
@@ -78,8 +199,16 @@ namespace Hardware {
             else ppu.write(address, u8);
         }
 
-        else if (address == 0xFF50) is_bootstrap_enabled = false; // Unmapping bootstrap
-        else if (address >= 0xFF80 && address < 0xFFFF) high_ram[address - 0xFF80] = u8;
+        else if (address == 0xFF50) { // Unmapping bootstrap
+            is_bootstrap_enabled = false;
+            map_rom_pages();
+        }
+
+        else if (address >= 0xFF80 && address < 0xFFFF) {
+            high_ram[address - 0xFF80] = u8;
+            if (cpu.block_cache.is_ram_page_cached[0xFF]) cpu.block_cache.invalidate_ram_page(0xFF);
+        }
+
         else if (address == 0xFFFF) cpu.interrupt_enabled = u8;
     }
 
@@ -90,11 +219,53 @@ namespace Hardware {
     }
 
 
+    // Copies 160 bytes into OAM, either all at once (the default) or over 160 M-cycles when timed DMA is enabled
+    // The source can't change during a timed transfer as the CPU is limited to high RAM, so it is copied up front and fed into OAM by run_dma
     void MMU::perform_dma_transfer(U8 encoded_source_address) {
 
         // The source address encoded as the source address bit shifted right by 8 so it can fit into a single byte.
         // Performing a bit shift left by 8 will return the actual source address
         U16 source_address = (U16)encoded_source_address << 8;
-        for (int i = 0; i < 160; i++ ) write_u8(0xFE00 + i, read_u8(source_address + i));
+        U8* destination = is_timed_dma_enabled ? dma_buffer : ppu.oam.get();
+        const U8* source_page = read_pages[encoded_source_address];
+        is_dma_active = false; // A transfer may be restarted part way through
+
+        if (source_page != nullptr) std::memcpy(destination, source_page, 160);
+        else for (int i = 0; i < 160; i++) destination[i] = handle_read_u8(source_address + i);
+        if (!is_timed_dma_enabled) ppu.are_line_objects_dirty = true;
+
+        if (bus_tracer.is_recording) {
+            for (int i = 0; i < 160; i++) bus_tracer.record(source_address + i, destination[i], false, BusTracer::FROM_DMA);
+            if (!is_timed_dma_enabled) for (int i = 0; i < 160; i++) bus_tracer.record(0xFE00 + i, destination[i], true, BusTracer::FROM_DMA);
+        }
+
+        if (!is_timed_dma_enabled) return;
+
+        // Every access from the CPU must go through the handlers while the transfer blocks the bus
+        is_dma_active = true;
+        dma_ticks = 0;
+        dma_bytes_copied = 0;
+        read_pages.fill(nullptr);
+        write_pages.fill(nullptr);
+        cpu.fetch_window_length = 0;
+    }
+
+
+    // Moves a timed transfer along by one byte every 4 ticks, and restores the CPU's access to memory once it completes
+    void MMU::run_dma(int ticks) {
+        if (!is_dma_active) return;
+        dma_ticks += ticks;
+        int total_bytes_copied = std::min(160, dma_ticks / 4);
+        std::memcpy(&ppu.oam[dma_bytes_copied], &dma_buffer[dma_bytes_copied], total_bytes_copied - dma_bytes_copied);
+        if (total_bytes_copied > dma_bytes_copied) ppu.are_line_objects_dirty = true;
+
+        if (bus_tracer.is_recording) {
+            for (int i = dma_bytes_copied; i < total_bytes_copied; i++) bus_tracer.record(0xFE00 + i, dma_buffer[i], true, BusTracer::FROM_DMA);
+        }
+
+        dma_bytes_copied = total_bytes_copied;
+        if (dma_bytes_copied < 160) return;
+        is_dma_active = false;
+        map_pages();
     }
 }
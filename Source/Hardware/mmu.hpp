@@ -4,11 +4,14 @@
 #include <cstdint>
 #include <string>
 #include <memory>
+#include <array>
 #include "cpu.hpp"
 #include "ppu.hpp"
 #include "cartridge.hpp"
 #include "joypad.hpp"
 #include "timer.hpp"
+#include "watchpoints.hpp"
+#include "bus_tracer.hpp"
 
 
 typedef unsigned char U8;
@@ -31,18 +34,36 @@ namespace Hardware {
         Joypad& joypad;
         Timer& timer;
         bool is_bootstrap_enabled;
+        bool are_rom_pages_mapped;
+        bool is_timed_dma_enabled;
+        bool is_dma_active;
+        int dma_ticks;
+        int dma_bytes_copied;
+        U8 dma_buffer[160];
         std::string exe_path;
         U8 bootstrap[256];
         std::unique_ptr<U8[]> work_ram;
         std::unique_ptr<U8[]> high_ram;
+        std::array<const U8*, 256> read_pages;
+        std::array<U8*, 256> write_pages;
+        Watchpoints watchpoints;
+        BusTracer bus_tracer;
 
         MMU(CPU& _cpu, PPU& _ppu, Cartridge& _cartridge, Joypad& Joypad, Timer& timer, std::string _exe_path);
         void reset();
         void load_bootstrap();
+        void set_bootstrap_enabled(bool state);
+        void map_pages();
+        void map_rom_pages();
+        void map_work_ram_page(U8 page);
+        void unmap_handled_pages();
         U8 read_u8(U16 address);
+        U8 handle_read_u8(U16 address);
         U16 read_u16(U16 address);
         void write_u8(U16 address, U8 u8);
+        void handle_write_u8(U16 address, U8 u8);
         void write_u16(U16 address, U16 u16);
         void perform_dma_transfer(U8 encoded_source_address);
+        void run_dma(int ticks);
     };
 }
\ No newline at end of file
@@ -0,0 +1,66 @@
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include "opcode_profiler.hpp"
+#include "mmu.hpp"
+
+
+namespace Hardware {
+
+    // Counts how often each pair of opcodes runs one straight after the other, prefixed opcodes being 0x1XX
+    // The most frequent pairs which can be fused are written out as the superinstruction table, which the CPU builds its fused handlers from
+    OpcodeProfiler::OpcodeProfiler(MMU& _mmu) :
+        mmu(_mmu),
+        is_enabled(false) {
+        reset();
+    }
+
+
+    // The counts are kept across resets so that several ROMs can be profiled together
+    void OpcodeProfiler::reset() {
+        previous_opcode = 0;
+        next_address = 0;
+    }
+
+
+    void OpcodeProfiler::record(U16 address) {
+        if (pair_counts.empty()) pair_counts.resize(512 * 512);
+        U16 opcode = mmu.handle_read_u8(address);
+        U16 length = BlockCache::instruction_lengths[opcode];
+        if (opcode == 0xCB) opcode = 0x100 | mmu.handle_read_u8(address + 1);
+
+        // Only pairs which sit next to each other in memory can be fused, so jumps between them aren't counted
+        if (address == next_address) pair_counts[previous_opcode << 9 | opcode]++;
+        previous_opcode = opcode;
+        next_address = address + length;
+    }
+
+
+    void OpcodeProfiler::write_table(std::string table_path, int total_entries) {
+        std::vector<int> pairs;
+
+        for (int pair = 0; pair < (int)pair_counts.size(); pair++) {
+            if (pair_counts[pair] > 0 && can_fuse(pair >> 9, pair & 0x1FF)) pairs.push_back(pair);
+        }
+
+        std::sort(pairs.begin(), pairs.end(), [this](int a, int b) {return pair_counts[a] > pair_counts[b];});
+        if ((int)pairs.size() > total_entries) pairs.resize(total_entries);
+        std::ofstream table(table_path);
+
+        if (!table.is_open()) {
+            std::cerr << "Error: could not write the superinstruction table to " << table_path << std::endl;
+            return;
+        }
+
+        table << "// Generated by OpcodeProfiler::write_table - the most frequent pairs of opcodes which can be fused, prefixed opcodes being 0x1XX\n";
+        table << "// Each entry is expanded into a fused handler by the CPU, with the number of times the pair ran while profiling\n";
+        table << "// Regenerated by setting IS_OPCODE_PROFILER_ENABLED in settings.json and playing the ROMs to profile, as antboy writes the table back here on exit\n";
+        table << std::hex << std::uppercase << std::setfill('0');
+
+        for (int pair : pairs) {
+            table << "SUPERINSTRUCTION(0x" << std::setw(3) << (pair >> 9) << ", 0x" << std::setw(3) << (pair & 0x1FF) << ") ";
+            table << "// " << std::dec << pair_counts[pair] << std::hex << "\n";
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+
+
+#include <cstdint>
+#include <vector>
+#include <string>
+#include "block_cache.hpp"
+
+
+typedef unsigned char U8;
+typedef unsigned short U16;
+
+
+namespace Hardware {
+    class MMU;
+
+
+    class OpcodeProfiler {
+    public:
+        MMU& mmu;
+        bool is_enabled;
+        std::vector<unsigned int> pair_counts;
+        U16 previous_opcode;
+        U16 next_address;
+
+        OpcodeProfiler(MMU& _mmu);
+        void reset();
+        void record(U16 address);
+        void write_table(std::string table_path, int total_entries);
+
+
+        // Whether an opcode only works on the CPU's registers, prefixed opcodes being 0x1XX
+        // HALT, STOP, DI, EI and the unused opcodes are excluded as they change more than the registers
+        static constexpr bool is_register_only(int opcode) {
+            if (opcode >= 0x100) return (opcode & 7) != 6;
+            if (opcode >= 0x40 && opcode < 0x80) return (opcode & 7) != 6 && (opcode & 0xF8) != 0x70;
+            if (opcode >= 0x80 && opcode < 0xC0) return (opcode & 7) != 6;
+
+            switch (opcode) {
+                case 0x02: case 0x08: case 0x0A: case 0x10: case 0x12: case 0x1A: case 0x22: case 0x2A:
+                case 0x32: case 0x34: case 0x35: case 0x36: case 0x3A: return false;
+                case 0xC2: case 0xC3: case 0xC6: case 0xCA: case 0xCE: case 0xD2: case 0xD6: case 0xDA: case 0xDE:
+                case 0xE6: case 0xE8: case 0xE9: case 0xEE: case 0xF6: case 0xF8: case 0xF9: case 0xFE: return true;
+                default: return opcode < 0xC0;
+            }
+        }
+
+
+        // Whether an opcode can write to memory, prefixed opcodes being 0x1XX
+        // Calls and restarts are left out as they already end their basic block
+        static constexpr bool can_write_memory(int opcode) {
+            if (opcode >= 0x100) return (opcode & 7) == 6 && (opcode < 0x140 || opcode >= 0x180); // BIT n,(HL) only reads
+            if (opcode >= 0x70 && opcode < 0x78) return true;
+
+            switch (opcode) {
+                case 0x02: case 0x08: case 0x12: case 0x22: case 0x32: case 0x34: case 0x35: case 0x36:
+                case 0xC5: case 0xD5: case 0xE0: case 0xE2: case 0xE5: case 0xEA: case 0xF5: return true;
+                default: return false;
+            }
+        }
+
+
+        // Pairs are fused when the second instruction can't observe or be observed by the rest of the system running between the two
+        // The first instruction can be anything which stays in its basic block, leaves the interrupt and halt state alone and doesn't write to memory
+        // A write could switch the ROM bank or overwrite the second instruction, which the fused handler would then run the stale copy of
+        static constexpr bool can_fuse(int first, int second) {
+            if (!is_register_only(second)) return false;
+            if (can_write_memory(first)) return false;
+            if (first >= 0x100) return true;
+            if (BlockCache::does_end_block(first)) return false;
+
+            switch (first) {
+                case 0xCB: case 0xF3: case 0xFB: return false;
+                case 0xD3: case 0xDB: case 0xDD: case 0xE3: case 0xE4: case 0xEB: case 0xEC: case 0xED: case 0xF4: case 0xFC: case 0xFD: return false;
+                default: return true;
+            }
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,155 @@
+#include "pixel_kernels.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define IS_X86_HOST
+    #include <immintrin.h>
+#endif
+
+
+namespace Hardware {
+
+    // Each row of a tile is stored as two bytes, the first holding the low bit of each pixel and the second the high bit, leftmost pixel first
+    static void decode_tile_rows_scalar(const U8* tile_data, U8* color_ids, int total_rows) {
+        for (int row = 0; row < total_rows; row++) {
+            U8 low_byte = tile_data[row * 2];
+            U8 high_byte = tile_data[row * 2 + 1];
+            for (int x = 0; x < 8; x++) color_ids[row * 8 + x] = ((high_byte >> (7 - x)) & 1) << 1 | ((low_byte >> (7 - x)) & 1);
+        }
+    }
+
+
+    static void map_colors_scalar(const U8* color_ids, U8* colors, int total_pixels, U8 palette) {
+        U8 palette_colors[4] = {(U8)(palette & 3), (U8)(palette >> 2 & 3), (U8)(palette >> 4 & 3), (U8)(palette >> 6 & 3)};
+        for (int i = 0; i < total_pixels; i++) colors[i] = palette_colors[color_ids[i]];
+    }
+
+
+    #ifdef IS_X86_HOST
+
+        // Eight rows at a time: the low and high bytes are split apart, each byte is spread across the 8 lanes of its row
+        // and every lane is then tested against the bit of its own pixel
+        __attribute__((target("sse2")))
+        static void decode_tile_rows_sse2(const U8* tile_data, U8* color_ids, int total_rows) {
+            const __m128i pixel_bits = _mm_set_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+            const __m128i ones = _mm_set1_epi8(1);
+            int row = 0;
+
+            for (; row + 8 <= total_rows; row += 8) {
+                __m128i bytes = _mm_loadu_si128((const __m128i*)(tile_data + row * 2));
+                __m128i low_bytes = _mm_packus_epi16(_mm_and_si128(bytes, _mm_set1_epi16(0xFF)), _mm_setzero_si128());
+                __m128i high_bytes = _mm_packus_epi16(_mm_srli_epi16(bytes, 8), _mm_setzero_si128());
+                low_bytes = _mm_unpacklo_epi8(low_bytes, low_bytes);
+                high_bytes = _mm_unpacklo_epi8(high_bytes, high_bytes);
+
+                // Each pass handles the 16 pixels of two rows
+                for (int pair = 0; pair < 4; pair++) {
+                    __m128i low = pair < 2 ? _mm_unpacklo_epi16(low_bytes, low_bytes) : _mm_unpackhi_epi16(low_bytes, low_bytes);
+                    __m128i high = pair < 2 ? _mm_unpacklo_epi16(high_bytes, high_bytes) : _mm_unpackhi_epi16(high_bytes, high_bytes);
+                    low = pair % 2 == 0 ? _mm_unpacklo_epi32(low, low) : _mm_unpackhi_epi32(low, low);
+                    high = pair % 2 == 0 ? _mm_unpacklo_epi32(high, high) : _mm_unpackhi_epi32(high, high);
+                    low = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(low, pixel_bits), pixel_bits), ones);
+                    high = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(high, pixel_bits), pixel_bits), ones);
+                    _mm_storeu_si128((__m128i*)(color_ids + (row + pair * 2) * 8), _mm_or_si128(_mm_add_epi8(high, high), low));
+                }
+            }
+
+            decode_tile_rows_scalar(tile_data + row * 2, color_ids + row * 8, total_rows - row);
+        }
+
+
+        // SSE2 has no byte shuffle, so each pixel picks its color by comparing its id against all four
+        __attribute__((target("sse2")))
+        static void map_colors_sse2(const U8* color_ids, U8* colors, int total_pixels, U8 palette) {
+            int i = 0;
+
+            for (; i + 16 <= total_pixels; i += 16) {
+                __m128i ids = _mm_loadu_si128((const __m128i*)(color_ids + i));
+                __m128i result = _mm_setzero_si128();
+                for (int id = 0; id < 4; id++) {
+                    __m128i is_id = _mm_cmpeq_epi8(ids, _mm_set1_epi8(id));
+                    result = _mm_or_si128(result, _mm_and_si128(is_id, _mm_set1_epi8(palette >> (id * 2) & 3)));
+                }
+
+                _mm_storeu_si128((__m128i*)(colors + i), result);
+            }
+
+            map_colors_scalar(color_ids + i, colors + i, total_pixels - i, palette);
+        }
+
+
+        // The 16 tile bytes of eight rows are copied into both halves of the register, so a shuffle can spread each byte across its row
+        __attribute__((target("avx2")))
+        static void decode_tile_rows_avx2(const U8* tile_data, U8* color_ids, int total_rows) {
+            const __m256i pixel_bits = _mm256_set1_epi64x(0x0102040810204080);
+            const __m256i ones = _mm256_set1_epi8(1);
+            int row = 0;
+
+            for (; row + 8 <= total_rows; row += 8) {
+                __m256i bytes = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(tile_data + row * 2)));
+
+                // Each pass handles the 32 pixels of four rows
+                for (int half = 0; half < 2; half++) {
+                    char first_byte = half * 8; // The low byte of the first of the four rows
+                    __m256i low_spread = _mm256_setr_epi64x(0x0101010101010101 * first_byte, 0x0101010101010101 * (first_byte + 2), 0x0101010101010101 * (first_byte + 4), 0x0101010101010101 * (first_byte + 6));
+                    __m256i high_spread = _mm256_add_epi8(low_spread, ones);
+                    __m256i low = _mm256_shuffle_epi8(bytes, low_spread);
+                    __m256i high = _mm256_shuffle_epi8(bytes, high_spread);
+                    low = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(low, pixel_bits), pixel_bits), ones);
+                    high = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(high, pixel_bits), pixel_bits), ones);
+                    _mm256_storeu_si256((__m256i*)(color_ids + (row + half * 4) * 8), _mm256_or_si256(_mm256_add_epi8(high, high), low));
+                }
+            }
+
+            decode_tile_rows_scalar(tile_data + row * 2, color_ids + row * 8, total_rows - row);
+        }
+
+
+        // The four palette colors sit at the front of a lookup register, which is indexed by the color ids with a byte shuffle
+        __attribute__((target("avx2")))
+        static void map_colors_avx2(const U8* color_ids, U8* colors, int total_pixels, U8 palette) {
+            __m256i palette_colors = _mm256_broadcastsi128_si256(_mm_setr_epi8(palette & 3, palette >> 2 & 3, palette >> 4 & 3, palette >> 6 & 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0));
+            int i = 0;
+
+            for (; i + 32 <= total_pixels; i += 32) {
+                __m256i ids = _mm256_loadu_si256((const __m256i*)(color_ids + i));
+                _mm256_storeu_si256((__m256i*)(colors + i), _mm256_shuffle_epi8(palette_colors, ids));
+            }
+
+            map_colors_sse2(color_ids + i, colors + i, total_pixels - i, palette);
+        }
+
+    #endif
+
+
+    PixelKernels::PixelKernels() {
+        select(SCALAR);
+
+        #ifdef IS_X86_HOST
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) select(AVX2);
+            else if (__builtin_cpu_supports("sse2")) select(SSE2);
+        #endif
+    }
+
+
+    // Falls back to the scalar kernels if the instruction set wasn't compiled in
+    void PixelKernels::select(int _instruction_set) {
+        instruction_set = SCALAR;
+        decode_tile_rows = decode_tile_rows_scalar;
+        map_colors = map_colors_scalar;
+
+        #ifdef IS_X86_HOST
+            if (_instruction_set == SSE2) {
+                instruction_set = SSE2;
+                decode_tile_rows = decode_tile_rows_sse2;
+                map_colors = map_colors_sse2;
+            }
+
+            else if (_instruction_set == AVX2) {
+                instruction_set = AVX2;
+                decode_tile_rows = decode_tile_rows_avx2;
+                map_colors = map_colors_avx2;
+            }
+        #endif
+    }
+}
\ No newline at end of file
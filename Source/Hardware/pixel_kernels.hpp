@@ -0,0 +1,23 @@
+#pragma once
+
+
+#include <cstdint>
+
+
+typedef unsigned char U8;
+
+
+namespace Hardware {
+
+    // Bulk pixel conversions for the PPU, using the widest vector instructions the host CPU supports
+    class PixelKernels {
+    public:
+        enum InstructionSet {SCALAR, SSE2, AVX2};
+        int instruction_set;
+        void (*decode_tile_rows)(const U8* tile_data, U8* color_ids, int total_rows);
+        void (*map_colors)(const U8* color_ids, U8* colors, int total_pixels, U8 palette);
+
+        PixelKernels();
+        void select(int _instruction_set);
+    };
+}
\ No newline at end of file
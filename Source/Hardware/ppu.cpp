@@ -1,9 +1,12 @@
 #include <cstdint>
 #include <cstring>
+#include <climits>
+#include <algorithm>
 #include "ppu.hpp"
 #include "mmu.hpp"
 #include "lcd.hpp"
 #include "cpu.hpp"
+#include "timer.hpp"
 #include "../Utilities/misc.hpp"
 
 
@@ -22,7 +25,9 @@ namespace Hardware {
         v_blank_interval(4560),
         oam_search_interval(80),
         pixel_transfer_interval(172),
-        current_scanline_buffer(std::make_unique<U8[]>(lcd.width)) {
+        current_scanline_buffer(std::make_unique<U8[]>(lcd.width)),
+        decoded_tiles(std::make_unique<U8[]>(384 * 64)),
+        is_tile_row_dirty(std::make_unique<bool[]>(384 * 8)) {
     }
 
 
@@ -34,11 +39,18 @@ namespace Hardware {
         scroll_y = 0;
         mode = H_BLANK;
         std::memset(video_ram.get(), 0, 8192);
+        std::fill_n(is_tile_row_dirty.get(), 384 * 8, true);
         std::memset(oam.get(), 0, 160);
+        are_line_objects_dirty = true;
+        last_run_tick = mmu.timer.total_ticks;
+        schedule_next_event();
     }
 
 
+    // Register accesses catch the PPU up first, so that it is never behind the CPU while it is being read from or written to
     U8 PPU::read(U16 address) {
+        run(0);
+
         switch (address) {
             case 0xFF40: return get_lcd_control();
             case 0xFF41: return get_lcd_status();
@@ -57,6 +69,8 @@ namespace Hardware {
 
 
     void PPU::write(U16 address, U8 u8) {
+        run(0);
+
         switch (address) {
             case 0xFF40: set_lcd_control(u8); break;
             case 0xFF41: set_lcd_status(u8); break;
@@ -69,6 +83,48 @@ namespace Hardware {
             case 0xFF4A: window_y = u8; break;
             case 0xFF4B: window_x = u8; break;
         }
+
+        schedule_next_event(); // Enabling or disabling the LCD moves the next mode switch
+    }
+
+
+    // The PPU has its own bus to video RAM, so it doesn't go through the MMU (which may be blocking the CPU during OAM DMA)
+    U8 PPU::read_video_ram_u8(U16 address) {
+        if (mmu.bus_tracer.is_recording) mmu.bus_tracer.record(address, video_ram[address - 0x8000], false, BusTracer::FROM_PPU);
+        return video_ram[address - 0x8000];
+    }
+
+
+    // Writes to the tile data (0x8000-0x97FF) come through here rather than the MMU's page table, so the tile row they change can be decoded again
+    void PPU::write_video_ram(U16 address, U8 u8) {
+        video_ram[address - 0x8000] = u8;
+        if (address < 0x9800) is_tile_row_dirty[(address - 0x8000) >> 1] = true;
+    }
+
+
+    // Any change to OAM can move objects between scanlines, so the objects on each line are selected again at the next OAM search
+    void PPU::write_oam(U16 address, U8 u8) {
+        oam[address - 0xFE00] = u8;
+        are_line_objects_dirty = true;
+    }
+
+
+    // Each of the 384 tiles is kept decoded as 8 rows of 8 color ids, the leftmost pixel first
+    // A row is only decoded the first time it is rendered after being written, along with the rest of its tile so the whole tile is converted in one go
+    const U8* PPU::get_decoded_tile_row(U16 address) {
+        int row = (address - 0x8000) >> 1;
+        U8* pixels = &decoded_tiles[row * 8];
+
+        if (mmu.bus_tracer.is_recording) {
+            mmu.bus_tracer.record(0x8000 + row * 2, video_ram[row * 2], false, BusTracer::FROM_PPU);
+            mmu.bus_tracer.record(0x8001 + row * 2, video_ram[row * 2 + 1], false, BusTracer::FROM_PPU);
+        }
+
+        if (!is_tile_row_dirty[row]) return pixels;
+        int tile = row >> 3;
+        pixel_kernels.decode_tile_rows(&video_ram[tile * 16], &decoded_tiles[tile * 64], 8);
+        std::fill_n(&is_tile_row_dirty[tile * 8], 8, false);
+        return pixels;
     }
 
 
@@ -78,6 +134,7 @@ namespace Hardware {
         is_window_enabled = Utilities::get_bit_u8(u8, 5);
         is_unsigned_background_tileset_selected = Utilities::get_bit_u8(u8, 4);
         is_background_tile_map_1_selected = Utilities::get_bit_u8(u8, 3);
+        if (are_objects_8x16 != Utilities::get_bit_u8(u8, 2)) are_line_objects_dirty = true; // The object height changes which lines each object covers
         are_objects_8x16 = Utilities::get_bit_u8(u8, 2);
         are_objects_enabled = Utilities::get_bit_u8(u8, 1);
         is_background_enabled = Utilities::get_bit_u8(u8, 0);
@@ -126,17 +183,35 @@ namespace Hardware {
     }
 
 
-    void PPU::run(int last_instruction_ticks) {
-        ticks += last_instruction_ticks;
-        if (!is_lcd_enabled) return; // Halts the PPU if the LCD is disabled
+    // Runs the PPU up to the timer's total ticks, which the emulation loop only does once the next mode switch is due
+    // Catching up without any instructions having finished (for register accesses) never switches modes, as the previous mode switch wasn't due yet
+    void PPU::run(int last_instruction_count) {
+        ticks += mmu.timer.total_ticks - last_run_tick;
+        last_run_tick = mmu.timer.total_ticks;
 
-        // Switches through modes 0-4
-        switch (mode) {
-            case H_BLANK: run_hblank(); break;
-            case V_BLANK: run_vblank(); break;
-            case OAM_SEARCH: run_oam_search(); break;
-            case PIXEL_TRANSFER: run_pixel_transfer(); break;
+        // Switches through modes 0-4, allowing at most one mode switch per instruction
+        // Several instructions are only run at once by the JIT, which matches running them one at a time
+        for (int i = 0; is_lcd_enabled && i < last_instruction_count; i++) {
+            int previous_ticks = ticks;
+
+            switch (mode) {
+                case H_BLANK: run_hblank(); break;
+                case V_BLANK: run_vblank(); break;
+                case OAM_SEARCH: run_oam_search(); break;
+                case PIXEL_TRANSFER: run_pixel_transfer(); break;
+            }
+
+            if (ticks == previous_ticks) break;
         }
+
+        schedule_next_event();
+    }
+
+
+    // The PPU is halted while the LCD is disabled, so it has nothing to run until the LCD is written to
+    void PPU::schedule_next_event() {
+        if (!is_lcd_enabled) next_event_tick = ULLONG_MAX;
+        else next_event_tick = last_run_tick + std::max(get_ticks_until_mode_switch(), 0);
     }
 
 
@@ -180,18 +255,47 @@ namespace Hardware {
 
 
     void PPU::run_oam_search() {
-        // Nothing needs to actually happen in OAM search mode (other than timing) to have accurate graphics for most ROMS
-        // Something which I could implement here is object orderin so that they are rendered on top of one another in the correct order
-        // However this isn't important to implement
-
         if (ticks < oam_search_interval) return;
 
         // PPU finishing OAM search mode and switching to pixel transfer mode
+        // The objects for every line are selected together, and only again once OAM or the object height has changed
+        if (are_line_objects_dirty) select_line_objects();
+        if (mmu.bus_tracer.is_recording) for (int i = 0; i < 160; i++) mmu.bus_tracer.record(0xFE00 + i, oam[i], false, BusTracer::FROM_PPU);
         ticks -= oam_search_interval;
         mode = PIXEL_TRANSFER;
     }
 
 
+    // Each scanline shows the first 10 objects in OAM which intersect it
+    // These are then ordered by priority - the object furthest left is drawn on top, with ties going to the object first in OAM
+    void PPU::select_line_objects() {
+        U8 object_height = are_objects_8x16 ? 16 : 8;
+        total_line_objects.fill(0);
+
+        for (int i = 0; i < 40; i++) {
+            int object_y = oam[i * 4] - 16; // 16 is subtracted as the object y actually stores the objects y position + 16
+
+            for (int y = std::max(object_y, 0); y < std::min(object_y + object_height, 144); y++) {
+                if (total_line_objects[y] == 10) continue;
+                line_objects[y][total_line_objects[y]++] = i;
+            }
+        }
+
+        // An insertion sort on the x position which keeps objects with the same x in OAM order
+        for (int y = 0; y < 144; y++) {
+            for (int i = 1; i < total_line_objects[y]; i++) {
+                U8 object = line_objects[y][i];
+                int j = i;
+
+                for (; j > 0 && oam[line_objects[y][j - 1] * 4 + 1] > oam[object * 4 + 1]; j--) line_objects[y][j] = line_objects[y][j - 1];
+                line_objects[y][j] = object;
+            }
+        }
+
+        are_line_objects_dirty = false;
+    }
+
+
 
     void PPU::run_pixel_transfer() {
 
@@ -205,6 +309,27 @@ namespace Hardware {
     }
 
 
+    // The PPU can only raise interrupts when switching modes, so nothing needs to run until then
+    int PPU::get_ticks_until_mode_switch() {
+        if (!is_lcd_enabled) return INT_MAX;
+
+        switch (mode) {
+            case H_BLANK: return h_blank_interval - ticks;
+            case V_BLANK: return v_blank_interval / 10 - ticks;
+            case OAM_SEARCH: return oam_search_interval - ticks;
+            case PIXEL_TRANSFER: return pixel_transfer_interval - ticks;
+            default: return 0;
+        }
+    }
+
+
+    // The same as above, but counting the ticks which have passed since the PPU was last run
+    int PPU::get_ticks_until_next_event() {
+        if (!is_lcd_enabled) return INT_MAX;
+        return (long long)next_event_tick - (long long)mmu.timer.total_ticks;
+    }
+
+
     void PPU::check_lcd_y_comparison() {
         if (scanline_y == scanline_y_comparison) {
             is_scanline_comparison_equal = true;
@@ -228,17 +353,6 @@ namespace Hardware {
     }
 
 
-    U8 PPU::get_color_from_id(U8 color_id, U8 palette) {
-        switch (color_id) {
-            case 0: return palette & 0b00000011;
-            case 1: return (palette & 0b00001100) >> 2;
-            case 2: return (palette & 0b00110000) >> 4;
-            case 3: return (palette & 0b11000000) >> 6;
-            default: return 0;
-        }
-    }
-
-
     void PPU::render_scanline() {
         if (is_background_enabled) render_background();
         if (is_window_enabled) render_window();
@@ -250,32 +364,23 @@ namespace Hardware {
         U16 tile_map_offset = is_background_tile_map_1_selected ? 0x9C00 : 0x9800; // The tile map offset to use for this scanline
         U8 background_y = scanline_y + scroll_y; // The y position of the current scanline pixel within the background map
         U8 tile_row = background_y >> 3; // The row of the tile, that the current pixel is in, within the background map
+        U8 background_x = scroll_x; // The x position of the current scanline pixel within the background map
+        int scanline_x = 0;
 
-
-        // Rendering each pixel in the scanline
-        for (U8 scanline_x = 0; scanline_x < 160; scanline_x++) {
-            U8 background_x = scanline_x + scroll_x; // The x position of the current scanline pixel within the background map
+        // Rendering the scanline a tile at a time, with the first and last tiles cut short when scroll x isn't a multiple of 8
+        while (scanline_x < lcd.width) {
             U8 tile_col = background_x >> 3; // The column of the tile, that the current pixel is in, within the background map
-            U8 tile_index = mmu.read_u8(tile_map_offset + tile_row * 32 + tile_col); // A pointer to the location of the tile in the selected tileset
-            U16 tile_line = mmu.read_u16(get_tile_location(tile_index) + (background_y % 8) * 2); // The row of pixels within the tile which the current pixel is locate in
-            U8 tile_line_high_byte = tile_line >> 8; // The high byte of the row of pixels - the byte containing the left bit of the pixels in the tile
-            U8 tile_line_low_byte = tile_line & 0xFF; // The low byte of the row of pixels - the byte containing the right bit of the pixels in the tile
-            U8 pixel_bit = 7 - (background_x % 8); // The bit position the current pixel is located within the pixel row
-            U8 pixel_bit_mask = 1 << pixel_bit; // The mask which extracts the left and right bits of the current pixel from the pixel row
-
-            // Getting the left and right bits of the pixels within the pixel row
-            U8 pixel_bit_high = ((tile_line_high_byte & pixel_bit_mask) >> pixel_bit) << 1;
-            U8 pixel_bit_low = (tile_line_low_byte & pixel_bit_mask) >> pixel_bit;
-
-            // The current pixel variable actual stores the pixel id which is used by the background palette to obtain a pixel color value
-            // Here the left and right pixel bits are combined to form the color id
-            // This is used to get the color of the actual pixel to be pushed to the LCD
-            U8 color_id = pixel_bit_high | pixel_bit_low;
-            U8 color = get_color_from_id(color_id, background_palette);
-            lcd.transfer_pixel(scanline_x, scanline_y, color);
-            current_scanline_buffer[scanline_x] = color_id;
+            U8 tile_index = read_video_ram_u8(tile_map_offset + tile_row * 32 + tile_col); // A pointer to the location of the tile in the selected tileset
+            const U8* tile_line = get_decoded_tile_row(get_tile_location(tile_index) + (background_y % 8) * 2); // The row of pixels within the tile which the current pixel is locate in
+            U8 tile_pixel_x = background_x % 8;
+            int pixel_count = std::min(8 - tile_pixel_x, lcd.width - scanline_x);
+            std::copy_n(tile_line + tile_pixel_x, pixel_count, &current_scanline_buffer[scanline_x]);
+            scanline_x += pixel_count;
+            background_x += pixel_count;
         }
 
+        // The color ids are used by the background palette to obtain the colors of the actual pixels to be pushed to the LCD
+        pixel_kernels.map_colors(current_scanline_buffer.get(), lcd.get_scanline(scanline_y), lcd.width, background_palette);
     }
 
 
@@ -285,57 +390,53 @@ namespace Hardware {
         U16 tile_map_offset = is_window_tile_map_1_selected ? 0x9C00 : 0x9800;
         U8 background_y = (scanline_y - window_y);
         U8 tile_row = background_y >> 3;
+        int total_pixels = lcd.width - window_x;
+        U8 color_ids[168]; // Room for the whole of the last tile, which can be cut short by the edge of the LCD
 
-        for (int i = 0; i < 160 - window_x; i++) {
+        // The window always starts on a tile boundary, so whole tiles are copied
+        for (int i = 0; i < total_pixels; i += 8) {
             U8 tile_col = i >> 3;
-            U8 tile_index = mmu.read_u8(tile_map_offset + tile_row * 32 + tile_col);
-            U16 tile_line = mmu.read_u16(get_tile_location(tile_index) + (background_y % 8) * 2);
-            U8 tile_line_high_byte = tile_line >> 8;
-            U8 tile_line_low_byte = tile_line & 0xFF;
-            U8 pixel_bit = 7 - (i % 8);
-            U8 pixel_bit_mask = 1 << pixel_bit;
-            U8 pixel_bit_high = ((tile_line_high_byte & pixel_bit_mask) >> pixel_bit) << 1;
-            U8 pixel_bit_low = (tile_line_low_byte & pixel_bit_mask) >> pixel_bit;
-            U8 color_id = pixel_bit_high | pixel_bit_low;
-            U8 color = get_color_from_id(color_id, background_palette);
-            lcd.transfer_pixel(window_x + i, scanline_y, color);
+            U8 tile_index = read_video_ram_u8(tile_map_offset + tile_row * 32 + tile_col);
+            std::copy_n(get_decoded_tile_row(get_tile_location(tile_index) + (background_y % 8) * 2), 8, &color_ids[i]);
         }
 
+        if (total_pixels > 0) pixel_kernels.map_colors(color_ids, lcd.get_scanline(scanline_y) + window_x, total_pixels, background_palette);
         window_x += 7;
     }
 
 
     void PPU::render_objects() {
-        for (int i = 0; i < 40; i++) {
+        U8 object_height = are_objects_8x16 ? 16 : 8;
+        bool is_object_pixel[160] = {}; // Whether a higher priority object has already covered each pixel of the scanline
 
-            // The attributes of the current object
-            U8 object_y = oam[i * 4];
-            U8 object_x = oam[i * 4 + 1];
-            U8 object_index = oam[i * 4 + 2];
-            U8 object_attributes = oam[i * 4 + 3];
-            U8 object_height = are_objects_8x16 ? 16 : 8;
+        // Rendering the objects selected for this scanline during OAM search, highest priority first
+        for (int i = 0; i < total_line_objects[scanline_y]; i++) {
 
-            if (!(scanline_y + 16 >= object_y && scanline_y + 16 < object_y + object_height)) continue; // Ignores objects which don't intersect the current scanline
+            // The attributes of the current object
+            int object = line_objects[scanline_y][i];
+            U8 object_y = oam[object * 4];
+            U8 object_x = oam[object * 4 + 1];
+            U8 object_index = oam[object * 4 + 2];
+            U8 object_attributes = oam[object * 4 + 3];
             object_y -= 16; // 16 is subtracted as the object y actually stores the objects y position + 16
             U8 tile_pixel_y = scanline_y - object_y; // The y position of the scanline of pixels within the object's tile
+            if (tile_pixel_y >= object_height) continue; // Ignores objects moved off the scanline since OAM search
             if (Utilities::get_bit_u8(object_attributes, 6)) tile_pixel_y = object_height - tile_pixel_y - 1; // Checks if the object is flipped vertically
-            U16 tile_line = mmu.read_u16(0x8000 + object_index * 16 + tile_pixel_y * 2);
-            U8 tile_line_high_byte = tile_line >> 8;
-            U8 tile_line_low_byte = tile_line & 0xFF;
+            const U8* tile_line = get_decoded_tile_row(0x8000 + object_index * 16 + tile_pixel_y * 2);
+            U8 colors[8];
+            pixel_kernels.map_colors(tile_line, colors, 8, Utilities::get_bit_u8(object_attributes, 4) ? object_palette_1 : object_palette_0);
 
             // Rendering each pixel of the object within the scanline
             for (int tile_pixel_x = 0; tile_pixel_x < 8; tile_pixel_x++) {
                 U8 scanline_x = object_x + tile_pixel_x;
                 if (!(scanline_x >= 8 && scanline_x < lcd.width + 8)) continue; // Ignores pixels outside the lcd bounds
                 scanline_x -= 8; // 8 is subtracted as the object x actually stores the objects x position + 8
-                U8 pixel_bit = Utilities::get_bit_u8(object_attributes, 5) ? tile_pixel_x : 7 - tile_pixel_x;
-                U8 pixel_bit_mask = 1 << pixel_bit;
-                U8 pixel_bit_high = ((tile_line_high_byte & pixel_bit_mask) >> pixel_bit) << 1;
-                U8 pixel_bit_low = (tile_line_low_byte & pixel_bit_mask) >> pixel_bit;
-                U8 color_id = pixel_bit_high | pixel_bit_low;
-                U8 palette = Utilities::get_bit_u8(object_attributes, 4) ? object_palette_1 : object_palette_0;
-                U8 color = get_color_from_id(color_id, palette);
+                U8 pixel_x = Utilities::get_bit_u8(object_attributes, 5) ? 7 - tile_pixel_x : tile_pixel_x; // Checks if the object is flipped horizontally
+                U8 color_id = tile_line[pixel_x];
+                U8 color = colors[pixel_x];
                 if (color_id == 0) continue; // Ignores transparent pixels
+                if (is_object_pixel[scanline_x]) continue; // Ignores pixels covered by a higher priority object, even where that object is hidden behind the background
+                is_object_pixel[scanline_x] = true;
                 if (!Utilities::get_bit_u8(object_attributes, 7)) lcd.transfer_pixel(scanline_x, scanline_y, color); // Checks if the sprite has priority over the background
                 else if (current_scanline_buffer[scanline_x] == 0) lcd.transfer_pixel(scanline_x, scanline_y, color); // Draws the pixel regardless of priority if the background pixel is transparent
             }
@@ -3,6 +3,8 @@
 
 #include <cstdint>
 #include <memory>
+#include <array>
+#include "pixel_kernels.hpp"
 
 
 typedef unsigned char U8;
@@ -22,6 +24,8 @@ namespace Hardware {
         LCD& lcd;
         CPU& cpu;
         int ticks;
+        unsigned long long last_run_tick; // The timer's total ticks when the PPU was last run
+        unsigned long long next_event_tick; // The timer's total ticks at the PPU's next mode switch
         int mode;
         int h_blank_interval;
         int v_blank_interval;
@@ -52,27 +56,40 @@ namespace Hardware {
         std::unique_ptr<U8[]> video_ram;
         std::unique_ptr<U8[]> oam;
         std::unique_ptr<U8[]> current_scanline_buffer;
+        std::unique_ptr<U8[]> decoded_tiles;
+        std::unique_ptr<bool[]> is_tile_row_dirty;
+        PixelKernels pixel_kernels;
+        std::array<std::array<U8, 10>, 144> line_objects; // The objects drawn on each scanline, highest priority first
+        std::array<int, 144> total_line_objects;
+        bool are_line_objects_dirty;
 
 
         PPU(MMU& _mmu, LCD& _lcd, CPU& _cpu);
         void reset();
         U8 read(U16 address);
         void write(U16 address, U8 u8);
+        U8 read_video_ram_u8(U16 address);
+        void write_video_ram(U16 address, U8 u8);
+        void write_oam(U16 address, U8 u8);
+        const U8* get_decoded_tile_row(U16 address);
         void set_lcd_control(U8 u8);
         U8 get_lcd_control();
         void set_lcd_status(U8 u8);
         U8 get_lcd_status();
-        void run(int last_instruction_ticks);
+        void run(int last_instruction_count);
+        void schedule_next_event();
         void run_hblank();
         void run_vblank();
         void run_oam_search();
+        void select_line_objects();
         void run_pixel_transfer();
+        int get_ticks_until_mode_switch();
+        int get_ticks_until_next_event();
         void check_lcd_y_comparison();
         void render_scanline();
         void render_background();
         void render_window();
         void render_objects();
         uint16_t get_tile_location(U8 tile_index);
-        U8 get_color_from_id(U8 color_id, U8 palette);
     };
 }
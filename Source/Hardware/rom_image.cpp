@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include "rom_image.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+
+namespace Hardware {
+
+    // A read-only ROM file mapped straight into memory rather than copied onto the heap, so loading it doesn't depend on its size
+    // Every cartridge in the process which inserts the same file shares one image, and other processes share its pages through the OS's file cache
+    // Files which are smaller than the size they need to be (see get_required_size) are copied into a zero padded buffer instead
+    RomImage::RomImage() :
+        data(nullptr),
+        size(0),
+        file_time(0),
+        mapping(nullptr),
+        mapping_size(0),
+        mapping_handle(nullptr) {
+    }
+
+
+    RomImage::~RomImage() {
+        if (mapping == nullptr) return;
+        #ifdef _WIN32
+            UnmapViewOfFile(mapping);
+            CloseHandle(mapping_handle);
+        #else
+            munmap(mapping, mapping_size);
+        #endif
+    }
+
+
+    // Images are shared for as long as any cartridge still holds them, and are reopened if the file has changed since
+    std::shared_ptr<RomImage> RomImage::open(std::string file_path) {
+        static std::mutex images_mutex;
+        static std::map<std::string, std::weak_ptr<RomImage>> images;
+        std::error_code error;
+        std::string key = std::filesystem::weakly_canonical(file_path, error).string();
+        if (error) key = file_path;
+        auto file_time = std::filesystem::last_write_time(file_path, error);
+        long long time = error ? 0 : (long long)file_time.time_since_epoch().count();
+        std::lock_guard<std::mutex> lock(images_mutex);
+        std::shared_ptr<RomImage> image = images[key].lock();
+        if (image != nullptr && image->file_time == time) return image;
+
+        image = std::make_shared<RomImage>();
+        image->file_path = file_path;
+        image->file_time = time;
+
+        if (!image->map_file()) {
+            std::cerr << "Error: Unable to open ROM " << file_path << std::endl;
+            image->padded_data = std::make_unique<U8[]>(32768);
+            image->data = image->padded_data.get();
+            image->size = 32768;
+        }
+
+        images[key] = image;
+        return image;
+    }
+
+
+    // The ROM must hold the larger of the file and the size in its header, rounded up to a whole number of 16 KB banks
+    // This keeps every bank the MBC can select within the ROM, even for files with a bad header
+    int RomImage::get_required_size(const U8* file_data, int file_size) {
+        U8 rom_size_code = file_size > 0x148 ? file_data[0x148] : 0;
+        int header_rom_size = rom_size_code <= 8 ? 32768 << rom_size_code : 0; // The unofficial sizes 0x52-0x54 are left to the file size
+        return std::max({header_rom_size, (file_size + 0x3FFF) / 0x4000 * 0x4000, 32768});
+    }
+
+
+    bool RomImage::map_file() {
+        #ifdef _WIN32
+            HANDLE file = CreateFileA(file_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE) return false;
+            LARGE_INTEGER file_size;
+            GetFileSizeEx(file, &file_size);
+            mapping_size = file_size.QuadPart;
+            mapping_handle = mapping_size == 0 ? nullptr : CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            CloseHandle(file); // The mapping keeps the file open
+            if (mapping_handle == nullptr) return false;
+            mapping = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+
+            if (mapping == nullptr) {
+                CloseHandle(mapping_handle);
+                return false;
+            }
+        #else
+            int file = ::open(file_path.c_str(), O_RDONLY);
+            if (file < 0) return false;
+            mapping_size = lseek(file, 0, SEEK_END);
+            mapping = mapping_size == 0 ? MAP_FAILED : mmap(nullptr, mapping_size, PROT_READ, MAP_SHARED, file, 0);
+            close(file); // The mapping keeps the file open
+
+            if (mapping == MAP_FAILED) {
+                mapping = nullptr;
+                return false;
+            }
+        #endif
+
+        data = (const U8*)mapping;
+        size = get_required_size(data, (int)mapping_size);
+        if (size == (int)mapping_size) return true;
+
+        // Reads past the end of a mapped file aren't allowed, so short files are copied over to a padded buffer
+        padded_data = std::make_unique<U8[]>(size);
+        std::memcpy(padded_data.get(), data, mapping_size);
+        data = padded_data.get();
+        return true;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+
+
+#include <cstdint>
+#include <string>
+#include <memory>
+
+
+typedef unsigned char U8;
+typedef unsigned short U16;
+
+
+namespace Hardware {
+    class RomImage {
+    public:
+        const U8* data;
+        int size;
+        std::string file_path;
+        long long file_time;
+        std::unique_ptr<U8[]> padded_data;
+        void* mapping;
+        size_t mapping_size;
+        void* mapping_handle;
+
+        RomImage();
+        ~RomImage();
+        static std::shared_ptr<RomImage> open(std::string file_path);
+        static int get_required_size(const U8* file_data, int file_size);
+        bool map_file();
+    };
+}
\ No newline at end of file
@@ -1,3 +1,4 @@
+#include <climits>
 #include "timer.hpp"
 #include "cpu.hpp"
 #include "mmu.hpp"
@@ -10,7 +11,8 @@ namespace Hardware {
     Timer::Timer(MMU& _mmu, CPU& _cpu) :
         mmu(_mmu),
         cpu(_cpu),
-        divider_period(256) {
+        divider_period(256),
+        total_ticks(0) {
         reset();
     }
 
@@ -71,7 +73,9 @@ namespace Hardware {
     }
 
 
+    // total_ticks is never reset, so that clocks which are worked out from it (the MBC3's real time clock) carry on across resets
     void Timer::run(int last_instruction_ticks) {
+        total_ticks += last_instruction_ticks;
         divider_ticks += last_instruction_ticks;
         counter_ticks += last_instruction_ticks;
         update_divider();
@@ -80,10 +84,10 @@ namespace Hardware {
 
 
     void Timer::update_divider() {
-        if (divider_ticks < divider_period) return;
-
-        divider_ticks -= divider_period;
-        divider++;
+        while (divider_ticks >= divider_period) {
+            divider_ticks -= divider_period;
+            divider++;
+        }
     }
 
 
@@ -103,4 +107,11 @@ namespace Hardware {
             }
         }
     }
+
+
+    // The counter can only raise an interrupt when it overflows, so its increments before then can be run all at once
+    int Timer::get_ticks_until_counter_overflow() {
+        if (!is_counter_enabled) return INT_MAX;
+        return (0xFF - counter) * counter_period + counter_period - counter_ticks;
+    }
 }
\ No newline at end of file
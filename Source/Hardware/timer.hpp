@@ -26,6 +26,7 @@ namespace Hardware {
         int counter_ticks;
         int divider_period;
         int divider_ticks;
+        unsigned long long total_ticks;
 
         Timer(MMU& _mmu, CPU& _cpu);
         void reset();
@@ -35,5 +36,6 @@ namespace Hardware {
         void run(int last_instruction_ticks);
         void update_divider();
         void update_counter();
+        int get_ticks_until_counter_overflow();
     };
 }
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include <sstream>
+#include <iomanip>
+#include "watchpoints.hpp"
+#include "mmu.hpp"
+
+
+namespace Hardware {
+
+    // Read, write and execution breakpoints on single addresses
+    // Pages holding a watched read or write address are left out of the MMU's page tables, so only accesses to those pages reach the checks in the handlers
+    // Execution breakpoints are checked by the CPU at each instruction boundary on pages marked in watched_pages[EXECUTE]
+    Watchpoints::Watchpoints(MMU& _mmu) :
+        mmu(_mmu) {
+        clear();
+    }
+
+
+    // The watchpoints themselves are kept across resets so that a ROM can be debugged from the start
+    void Watchpoints::reset() {
+        is_hit = false;
+        resumed_address = -1;
+    }
+
+
+    void Watchpoints::add(Type type, U16 address) {
+        if (!addresses[type].insert(address).second) return;
+        watched_pages[type][address >> 8]++;
+        total_watchpoints++;
+        if (type != EXECUTE && !mmu.is_dma_active) mmu.map_pages(); // A timed OAM DMA maps the pages itself once it completes
+    }
+
+
+    void Watchpoints::remove(Type type, U16 address) {
+        if (addresses[type].erase(address) == 0) return;
+        watched_pages[type][address >> 8]--;
+        total_watchpoints--;
+        if (type != EXECUTE && !mmu.is_dma_active) mmu.map_pages();
+    }
+
+
+    void Watchpoints::clear() {
+        for (auto& type_addresses : addresses) type_addresses.clear();
+        for (auto& type_pages : watched_pages) type_pages.fill(0);
+        total_watchpoints = 0;
+        reset();
+    }
+
+
+    // Called for every access to a watched page, the hit being handled by Gameboy::emulate once the accessing instruction has completed
+    void Watchpoints::check_access(Type type, U16 address, U8 u8) {
+        if (is_hit || addresses[type].count(address) == 0) return;
+        is_hit = true;
+        hit_type = type;
+        hit_address = address;
+        hit_value = u8;
+    }
+
+
+    // Called before each instruction on a watched page, returning whether the instruction should be stopped before it runs
+    // The instruction a breakpoint was resumed from is let through once, so that resuming doesn't hit the same breakpoint again
+    bool Watchpoints::check_execution(U16 address) {
+        bool is_resumed_address = address == resumed_address;
+        resumed_address = -1;
+        if (is_hit || is_resumed_address || addresses[EXECUTE].count(address) == 0) return is_hit;
+        is_hit = true;
+        hit_type = EXECUTE;
+        hit_address = address;
+        hit_value = 0;
+        return true;
+    }
+
+
+    void Watchpoints::resume() {
+        if (!is_hit) return;
+        is_hit = false;
+        if (hit_type == EXECUTE) resumed_address = hit_address;
+    }
+
+
+    // Describes the last hit along with the CPU's registers
+    // Only called by Gameboy::emulate once it has stopped at an instruction boundary, as reading AF evaluates the lazy flags
+    std::string Watchpoints::get_report() {
+        const char* type_names[3] = {"Read watchpoint", "Write watchpoint", "Breakpoint"};
+        CPU& cpu = mmu.cpu;
+        std::stringstream report;
+        report << std::hex << std::uppercase << std::setfill('0');
+        report << type_names[hit_type] << " hit at 0x" << std::setw(4) << hit_address;
+        if (hit_type != EXECUTE) report << " (0x" << std::setw(2) << (int)hit_value << ")";
+        report << "\n";
+        report << "    PC: 0x" << std::setw(4) << cpu.program_counter << "  SP: 0x" << std::setw(4) << cpu.stack_pointer << "\n";
+        report << "    AF: 0x" << std::setw(4) << cpu.read_AF() << "  BC: 0x" << std::setw(4) << cpu.BC;
+        report << "  DE: 0x" << std::setw(4) << cpu.DE << "  HL: 0x" << std::setw(4) << cpu.HL << "\n";
+        return report.str();
+    }
+}
\ No newline at end of file
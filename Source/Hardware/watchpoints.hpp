@@ -0,0 +1,41 @@
+#pragma once
+
+
+#include <cstdint>
+#include <array>
+#include <string>
+#include <unordered_set>
+
+
+typedef unsigned char U8;
+typedef unsigned short U16;
+
+
+namespace Hardware {
+    class MMU;
+
+
+    class Watchpoints {
+    public:
+        enum Type {READ, WRITE, EXECUTE};
+        MMU& mmu;
+        std::array<std::unordered_set<U16>, 3> addresses;
+        std::array<std::array<int, 256>, 3> watched_pages; // The number of watched addresses in each page
+        int total_watchpoints;
+        bool is_hit;
+        Type hit_type;
+        U16 hit_address;
+        U8 hit_value;
+        int resumed_address;
+
+        Watchpoints(MMU& _mmu);
+        void reset();
+        void add(Type type, U16 address);
+        void remove(Type type, U16 address);
+        void clear();
+        void check_access(Type type, U16 address, U8 u8);
+        bool check_execution(U16 address);
+        void resume();
+        std::string get_report();
+    };
+}
\ No newline at end of file
@@ -1,4 +1,3 @@
-#include <tuple>
 #include "alu_opcodes.hpp"
 #include "opcodes_helper.hpp"
 #include "../Hardware/cpu.hpp"
@@ -7,16 +6,10 @@
 
 namespace Opcodes {
 
+    // The 8-bit ALU operations only record their operands, as their flags are usually overwritten before being read
     void ADD_n(Hardware::CPU& cpu, U8 u8) {
-        std::tuple<U8, bool, bool> result = add_u8(cpu.A, u8, 7, 3);
-        U8 sum = std::get<0>(result);
-        bool is_half_carry = std::get<1>(result);
-        bool is_carry = std::get<2>(result);
-        cpu.set_flag(Hardware::CPU::Flag::ZERO, sum == 0);
-        cpu.set_flag(Hardware::CPU::Flag::SUB, false);
-        cpu.set_flag(Hardware::CPU::Flag::HALF_CARRY, is_half_carry);
-        cpu.set_flag(Hardware::CPU::Flag::CARRY, is_carry);
-        cpu.A = sum;
+        cpu.set_lazy_flags(Hardware::CPU::ADD_OPERATION, cpu.A, u8, false);
+        cpu.A += u8;
     }
 
 
@@ -27,35 +20,22 @@ namespace Opcodes {
 
 
     int ADD_u8(Hardware::CPU& cpu) {
-        ADD_n(cpu, cpu.mmu.read_u8(cpu.program_counter));
-        cpu.program_counter++;
+        ADD_n(cpu, cpu.fetch());
         return 8;
     }
 
 
     int ADD_ptr_HL(Hardware::CPU& cpu) {
-        U16 hl_pointer = cpu.read_combined_register(cpu.HL);
+        U16 hl_pointer = cpu.HL;
         ADD_n(cpu, cpu.mmu.read_u8(hl_pointer));
         return 8;
     }
 
 
     void ADC_n(Hardware::CPU& cpu, U8 u8) {
-        std::tuple<U8, bool, bool> result = add_u8((U8)cpu.get_flag(Hardware::CPU::Flag::CARRY), u8, 7, 3);
-        U8 sum = std::get<0>(result);
-        bool is_half_carry = std::get<1>(result);
-        bool is_carry = std::get<2>(result);
-        cpu.set_flag(Hardware::CPU::Flag::SUB, false);
-        cpu.set_flag(Hardware::CPU::Flag::HALF_CARRY, is_half_carry);
-        cpu.set_flag(Hardware::CPU::Flag::CARRY, is_carry);
-        result = add_u8(cpu.A, sum, 7, 3);
-        sum = std::get<0>(result);
-        is_half_carry = std::get<1>(result);
-        is_carry = std::get<2>(result);
-        cpu.set_flag(Hardware::CPU::Flag::ZERO, sum == 0);
-        if (!cpu.get_flag(Hardware::CPU::Flag::HALF_CARRY)) cpu.set_flag(Hardware::CPU::Flag::HALF_CARRY, is_half_carry);
-        if (!cpu.get_flag(Hardware::CPU::Flag::CARRY)) cpu.set_flag(Hardware::CPU::Flag::CARRY, is_carry);
-        cpu.A = sum;
+        bool carry = cpu.get_lazy_carry();
+        cpu.set_lazy_flags(Hardware::CPU::ADC_OPERATION, cpu.A, u8, carry);
+        cpu.A += u8 + carry;
     }
 
 
@@ -66,29 +46,21 @@ namespace Opcodes {
 
 
     int ADC_u8(Hardware::CPU& cpu) {
-        ADC_n(cpu, cpu.mmu.read_u8(cpu.program_counter));
-        cpu.program_counter++;
+        ADC_n(cpu, cpu.fetch());
         return 8;
     }
 
 
     int ADC_ptr_HL(Hardware::CPU& cpu) {
-        U16 hl_pointer = cpu.read_combined_register(cpu.HL);
+        U16 hl_pointer = cpu.HL;
         ADC_n(cpu, cpu.mmu.read_u8(hl_pointer));
         return 8;
     }
 
 
     void SUB_n(Hardware::CPU& cpu, U8 u8) {
-        std::tuple<U8, bool, bool> result = sub_u8(cpu.A, u8, 3);
-        U8 difference = std::get<0>(result);
-        bool is_half_carry = std::get<1>(result);
-        bool is_carry = std::get<2>(result);
-        cpu.set_flag(Hardware::CPU::Flag::ZERO, difference == 0);
-        cpu.set_flag(Hardware::CPU::Flag::SUB, true);
-        cpu.set_flag(Hardware::CPU::Flag::HALF_CARRY, is_half_carry);
-        cpu.set_flag(Hardware::CPU::Flag::CARRY, is_carry);
-        cpu.A = difference;
+        cpu.set_lazy_flags(Hardware::CPU::SUB_OPERATION, cpu.A, u8, false);
+        cpu.A -= u8;
     }
 
 
@@ -99,36 +71,22 @@ namespace Opcodes {
 
 
     int SUB_u8(Hardware::CPU& cpu) {
-        SUB_n(cpu, cpu.mmu.read_u8(cpu.program_counter));
-        cpu.program_counter++;
+        SUB_n(cpu, cpu.fetch());
         return 8;
     }
 
 
     int SUB_ptr_HL(Hardware::CPU& cpu) {
-        U16 hl_pointer = cpu.read_combined_register(cpu.HL);
+        U16 hl_pointer = cpu.HL;
         SUB_n(cpu, cpu.mmu.read_u8(hl_pointer));
         return 8;
     }
 
 
     void SBC_n(Hardware::CPU& cpu, U8 u8) {
-        std::tuple<U8, bool, bool> result = add_u8((U8)cpu.get_flag(Hardware::CPU::Flag::CARRY), u8, 7, 3);
-        U8 difference = std::get<0>(result);
-        bool is_half_carry = std::get<1>(result);
-        bool is_carry = std::get<2>(result);
-        cpu.set_flag(Hardware::CPU::Flag::SUB, true);
-        cpu.set_flag(Hardware::CPU::Flag::HALF_CARRY, is_half_carry);
-        cpu.set_flag(Hardware::CPU::Flag::CARRY, is_carry);
-        result = sub_u8(cpu.A, difference, 3);
-        difference = std::get<0>(result);
-        is_half_carry = std::get<1>(result);
-        is_carry = std::get<2>(result);
-        cpu.set_flag(Hardware::CPU::Flag::ZERO, difference == 0);
-        if (!cpu.get_flag(Hardware::CPU::Flag::HALF_CARRY)) cpu.set_flag(Hardware::CPU::Flag::HALF_CARRY, is_half_carry);
-        if (!cpu.get_flag(Hardware::CPU::Flag::CARRY)) cpu.set_flag(Hardware::CPU::Flag::CARRY, is_carry);
-
-        cpu.A = difference;
+        bool carry = cpu.get_lazy_carry();
+        cpu.set_lazy_flags(Hardware::CPU::SBC_OPERATION, cpu.A, u8, carry);
+        cpu.A -= u8 + carry;
     }
 
 
@@ -139,28 +97,21 @@ namespace Opcodes {
 
 
     int SBC_u8(Hardware::CPU& cpu) {
-        SBC_n(cpu, cpu.mmu.read_u8(cpu.program_counter));
-        cpu.program_counter++;
+        SBC_n(cpu, cpu.fetch());
         return 8;
     }
 
 
     int SBC_ptr_HL(Hardware::CPU& cpu) {
-        U16 hl_pointer = cpu.read_combined_register(cpu.HL);
+        U16 hl_pointer = cpu.HL;
         SBC_n(cpu, cpu.mmu.read_u8(hl_pointer));
         return 8;
     }
 
 
     void INC_n(Hardware::CPU& cpu, U8& u8) {
-        std::tuple<U8, bool, bool> result = add_u8(u8, 1, 7, 3);
-        U8 sum = std::get<0>(result);
-        bool is_half_carry = std::get<1>(result);
-        bool is_carry = std::get<2>(result);
-        cpu.set_flag(Hardware::CPU::Flag::ZERO, sum == 0);
-        cpu.set_flag(Hardware::CPU::Flag::SUB, false);
-        cpu.set_flag(Hardware::CPU::Flag::HALF_CARRY, is_half_carry);
-        u8 = sum;
+        cpu.set_lazy_flags(Hardware::CPU::INC_OPERATION, u8, 1, cpu.get_lazy_carry());
+        u8++;
     }
 
 
@@ -171,7 +122,7 @@ namespace Opcodes {
 
 
     int INC_ptr_HL(Hardware::CPU& cpu) {
-        U16 hl_pointer = cpu.read_combined_register(cpu.HL);
+        U16 hl_pointer = cpu.HL;
         U8 u8 = cpu.mmu.read_u8(hl_pointer);
         INC_n(cpu, u8);
         cpu.mmu.write_u8(hl_pointer, u8);
@@ -180,14 +131,8 @@ namespace Opcodes {
 
 
     void DEC_n(Hardware::CPU& cpu, U8& u8) {
-        std::tuple<U8, bool, bool> result = sub_u8(u8, 1, 3);
-        U8 difference = std::get<0>(result);
-        bool is_half_carry = std::get<1>(result);
-        bool is_carry = std::get<2>(result);
-        cpu.set_flag(Hardware::CPU::Flag::ZERO, difference == 0);
-        cpu.set_flag(Hardware::CPU::Flag::SUB, true);
-        cpu.set_flag(Hardware::CPU::Flag::HALF_CARRY, is_half_carry);
-        u8 = difference;
+        cpu.set_lazy_flags(Hardware::CPU::DEC_OPERATION, u8, 1, cpu.get_lazy_carry());
+        u8--;
     }
 
 
@@ -198,7 +143,7 @@ namespace Opcodes {
 
 
     int DEC_ptr_HL(Hardware::CPU& cpu) {
-        U16 hl_pointer = cpu.read_combined_register(cpu.HL);
+        U16 hl_pointer = cpu.HL;
         U8 u8 = cpu.mmu.read_u8(hl_pointer);
         DEC_n(cpu, u8);
         cpu.mmu.write_u8(hl_pointer, u8);
@@ -208,10 +153,7 @@ namespace Opcodes {
 
     void AND_n(Hardware::CPU& cpu, U8 u8) {
         cpu.A &= u8;
-        cpu.set_flag(Hardware::CPU::Flag::ZERO, cpu.A == 0);
-        cpu.set_flag(Hardware::CPU::Flag::SUB, false);
-        cpu.set_flag(Hardware::CPU::Flag::HALF_CARRY, true);
-        cpu.set_flag(Hardware::CPU::Flag::CARRY, false);
+        cpu.set_lazy_flags(Hardware::CPU::AND_OPERATION, cpu.A, 0, false);
     }
 
 
@@ -222,14 +164,13 @@ namespace Opcodes {
 
 
     int AND_u8(Hardware::CPU& cpu) {
-        AND_n(cpu, cpu.mmu.read_u8(cpu.program_counter));
-        cpu.program_counter++;
+        AND_n(cpu, cpu.fetch());
         return 8;
     }
 
 
     int AND_ptr_HL(Hardware::CPU& cpu) {
-        U16 hl_pointer = cpu.read_combined_register(cpu.HL);
+        U16 hl_pointer = cpu.HL;
         AND_n(cpu, cpu.mmu.read_u8(hl_pointer));
         return 8;
     }
@@ -237,10 +178,7 @@ namespace Opcodes {
 
     void OR_n(Hardware::CPU& cpu, U8 u8) {
         cpu.A |= u8;
-        cpu.set_flag(Hardware::CPU::Flag::ZERO, cpu.A == 0);
-        cpu.set_flag(Hardware::CPU::Flag::SUB, false);
-        cpu.set_flag(Hardware::CPU::Flag::HALF_CARRY, false);
-        cpu.set_flag(Hardware::CPU::Flag::CARRY, false);
+        cpu.set_lazy_flags(Hardware::CPU::LOGICAL_OPERATION, cpu.A, 0, false);
     }
 
 
@@ -251,14 +189,13 @@ namespace Opcodes {
 
 
     int OR_u8(Hardware::CPU& cpu) {
-        OR_n(cpu, cpu.mmu.read_u8(cpu.program_counter));
-        cpu.program_counter++;
+        OR_n(cpu, cpu.fetch());
         return 8;
     }
 
 
     int OR_ptr_HL(Hardware::CPU& cpu) {
-        U16 hl_pointer = cpu.read_combined_register(cpu.HL);
+        U16 hl_pointer = cpu.HL;
         OR_n(cpu, cpu.mmu.read_u8(hl_pointer));
         return 8;
     }
@@ -266,10 +203,7 @@ namespace Opcodes {
 
     void XOR_n(Hardware::CPU& cpu, U8 u8) {
         cpu.A ^= u8;
-        cpu.set_flag(Hardware::CPU::Flag::ZERO, cpu.A == 0);
-        cpu.set_flag(Hardware::CPU::Flag::SUB, false);
-        cpu.set_flag(Hardware::CPU::Flag::HALF_CARRY, false);
-        cpu.set_flag(Hardware::CPU::Flag::CARRY, false);
+        cpu.set_lazy_flags(Hardware::CPU::LOGICAL_OPERATION, cpu.A, 0, false);
     }
 
 
@@ -280,28 +214,20 @@ namespace Opcodes {
 
 
     int XOR_u8(Hardware::CPU& cpu) {
-        XOR_n(cpu, cpu.mmu.read_u8(cpu.program_counter));
-        cpu.program_counter++;
+        XOR_n(cpu, cpu.fetch());
         return 8;
     }
 
 
     int XOR_ptr_HL(Hardware::CPU& cpu) {
-        U16 hl_pointer = cpu.read_combined_register(cpu.HL);
+        U16 hl_pointer = cpu.HL;
         XOR_n(cpu, cpu.mmu.read_u8(hl_pointer));
         return 8;
     }
 
 
     void CP_n(Hardware::CPU& cpu, U8 u8) {
-        std::tuple<U8, bool, bool> result = sub_u8(cpu.A, u8, 3);
-        U8 difference = std::get<0>(result);
-        bool is_half_carry = std::get<1>(result);
-        bool is_carry = std::get<2>(result);
-        cpu.set_flag(Hardware::CPU::Flag::ZERO, difference == 0);
-        cpu.set_flag(Hardware::CPU::Flag::SUB, true);
-        cpu.set_flag(Hardware::CPU::Flag::HALF_CARRY, is_half_carry);
-        cpu.set_flag(Hardware::CPU::Flag::CARRY, is_carry);
+        cpu.set_lazy_flags(Hardware::CPU::SUB_OPERATION, cpu.A, u8, false);
     }
 
 
@@ -312,14 +238,13 @@ namespace Opcodes {
 
 
     int CP_u8(Hardware::CPU& cpu) {
-        CP_n(cpu, cpu.mmu.read_u8(cpu.program_counter));
-        cpu.program_counter++;
+        CP_n(cpu, cpu.fetch());
         return 8;
     }
 
 
     int CP_ptr_HL(Hardware::CPU& cpu) {
-        U16 hl_pointer = cpu.read_combined_register(cpu.HL);
+        U16 hl_pointer = cpu.HL;
         CP_n(cpu, cpu.mmu.read_u8(hl_pointer));
         return 8;
     }
@@ -333,14 +258,14 @@ namespace Opcodes {
     }
 
 
-    int DEC_rr(Hardware::CPU& cpu, Hardware::CPU::CombinedRegister combined_register) {
-        cpu.write_combined_register(combined_register, cpu.read_combined_register(combined_register) - 1);
+    int DEC_rr(Hardware::CPU& cpu, U16& combined_register) {
+        combined_register--;
         return 8;
     }
 
 
-    int INC_rr(Hardware::CPU& cpu, Hardware::CPU::CombinedRegister combined_register) {
-        cpu.write_combined_register(combined_register, cpu.read_combined_register(combined_register) + 1);
+    int INC_rr(Hardware::CPU& cpu, U16& combined_register) {
+        combined_register++;
         return 8;
     }
 
@@ -358,20 +283,16 @@ namespace Opcodes {
 
 
     void ADD_HL_nn(Hardware::CPU& cpu, U16 u16) {
-        U16 hl_pointer = cpu.read_combined_register(cpu.HL);
-        std::tuple<U16, bool, bool> result = add_u16(hl_pointer, u16, 15, 11);
-        U16 sum = std::get<0>(result);
-        bool is_half_carry = std::get<1>(result);
-        bool is_carry = std::get<2>(result);
+        U16 hl_pointer = cpu.HL;
         cpu.set_flag(Hardware::CPU::Flag::SUB, false);
-        cpu.set_flag(Hardware::CPU::Flag::HALF_CARRY, is_half_carry);
-        cpu.set_flag(Hardware::CPU::Flag::CARRY, is_carry);
-        cpu.write_combined_register(cpu.HL, sum);
+        cpu.set_flag(Hardware::CPU::Flag::HALF_CARRY, check_half_carry_u16(hl_pointer, u16));
+        cpu.set_flag(Hardware::CPU::Flag::CARRY, check_carry_u16(hl_pointer, u16));
+        cpu.HL = hl_pointer + u16;
     }
 
 
-    int ADD_HL_rr(Hardware::CPU& cpu, Hardware::CPU::CombinedRegister combined_register) {
-        ADD_HL_nn(cpu, cpu.read_combined_register(combined_register));
+    int ADD_HL_rr(Hardware::CPU& cpu, U16 combined_register) {
+        ADD_HL_nn(cpu, combined_register);
         return 8;
     }
 
@@ -383,19 +304,14 @@ namespace Opcodes {
 
 
     int ADD_SP_s8(Hardware::CPU& cpu) {
-        U8 s8 = cpu.mmu.read_u8(cpu.program_counter);
-        std::tuple<U16, bool, bool> result;
-        if (Utilities::get_bit_u8(s8, 7)) result = add_u16(cpu.stack_pointer, (U16)s8 | 0xFF00, 7, 3);
-        else result = add_u16(cpu.stack_pointer, s8, 7, 3);
-        U16 sum = std::get<0>(result);
-        bool is_half_carry = std::get<1>(result);
-        bool is_carry = std::get<2>(result);
+        U8 s8 = cpu.fetch();
+
+        // The flags come from adding the offset to the low byte of SP as though both were unsigned
         cpu.set_flag(Hardware::CPU::Flag::ZERO, false);
         cpu.set_flag(Hardware::CPU::Flag::SUB, false);
-        cpu.set_flag(Hardware::CPU::Flag::HALF_CARRY, is_half_carry);
-        cpu.set_flag(Hardware::CPU::Flag::CARRY, is_carry);
-        cpu.stack_pointer = sum;
-        cpu.program_counter++;
+        cpu.set_flag(Hardware::CPU::Flag::HALF_CARRY, check_half_carry_u8(cpu.stack_pointer, s8, false));
+        cpu.set_flag(Hardware::CPU::Flag::CARRY, check_carry_u8(cpu.stack_pointer, s8, false));
+        cpu.stack_pointer += (signed char)s8;
         return 16;
     }
 
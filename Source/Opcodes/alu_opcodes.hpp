@@ -49,12 +49,12 @@ namespace Opcodes {
     int CP_u8(Hardware::CPU& cpu);
     int CP_ptr_HL(Hardware::CPU& cpu);
     int CPL(Hardware::CPU& cpu);
-    int DEC_rr(Hardware::CPU& cpu, Hardware::CPU::CombinedRegister combined_register);
-    int INC_rr(Hardware::CPU& cpu, Hardware::CPU::CombinedRegister combined_register);
+    int DEC_rr(Hardware::CPU& cpu, U16& combined_register);
+    int INC_rr(Hardware::CPU& cpu, U16& combined_register);
     int DEC_SP(Hardware::CPU& cpu);
     int INC_SP(Hardware::CPU& cpu);
     void ADD_HL_nn(Hardware::CPU& cpu, U16 u16);
-    int ADD_HL_rr(Hardware::CPU& cpu, Hardware::CPU::CombinedRegister combined_register);
+    int ADD_HL_rr(Hardware::CPU& cpu, U16 combined_register);
     int ADD_HL_SP(Hardware::CPU& cpu);
     int ADD_SP_s8(Hardware::CPU& cpu);
 };
\ No newline at end of file
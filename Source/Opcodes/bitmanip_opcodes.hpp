@@ -10,39 +10,81 @@ typedef unsigned short U16;
 
 
 namespace Opcodes {
-    void BIT_b_n(Hardware::CPU& cpu, int b, U8 u8);
-    int BIT_b_r(Hardware::CPU& cpu, int b, U8 reg);
-    int BIT_b_ptr_HL(Hardware::CPU& cpu, int b);
-    int SET_b_r(Hardware::CPU& cpu, int b, U8& reg);
-    int SET_b_ptr_HL(Hardware::CPU& cpu, int b);
-    int RES_b_r(Hardware::CPU& cpu, int b, U8& reg);
-    int RES_b_ptr_HL(Hardware::CPU& cpu, int b);
     void SWAP_n(Hardware::CPU& cpu, U8& u8);
-    int SWAP_r(Hardware::CPU& cpu, U8& reg);
-    int SWAP_ptr_HL(Hardware::CPU& cpu);
     void RL_n(Hardware::CPU& cpu, U8& u8);
-    int RL_r(Hardware::CPU& cpu, U8& reg);
-    int RL_ptr_HL(Hardware::CPU& cpu);
     void RLC_n(Hardware::CPU& cpu, U8& u8);
-    int RLC_r(Hardware::CPU& cpu, U8& reg);
-    int RLC_ptr_HL(Hardware::CPU& cpu);
     void RR_n(Hardware::CPU& cpu, U8& u8);
-    int RR_r(Hardware::CPU& cpu, U8& reg);
-    int RR_ptr_HL(Hardware::CPU& cpu);
     void RRC_n(Hardware::CPU& cpu, U8& u8);
-    int RRC_r(Hardware::CPU& cpu, U8& reg);
-    int RRC_ptr_HL(Hardware::CPU& cpu);
     int RLA(Hardware::CPU& cpu);
     int RLCA(Hardware::CPU& cpu);
     int RRA(Hardware::CPU& cpu);
     int RRCA(Hardware::CPU& cpu);
     void SLA_n(Hardware::CPU& cpu, U8& u8);
-    int SLA_r(Hardware::CPU& cpu, U8& reg);
-    int SLA_ptr_HL(Hardware::CPU& cpu);
     void SRA_n(Hardware::CPU& cpu, U8& u8);
-    int SRA_r(Hardware::CPU& cpu, U8& reg);
-    int SRA_ptr_HL(Hardware::CPU& cpu);
     void SRL_n(Hardware::CPU& cpu, U8& u8);
-    int SRL_r(Hardware::CPU& cpu, U8& reg);
-    int SRL_ptr_HL(Hardware::CPU& cpu);
+
+
+    // Operand indices follow the opcode encoding, with 6 being (HL) rather than a register
+    template <int index>
+    U8& get_register(Hardware::CPU& cpu) {
+        static_assert(index != 6, "(HL) isn't a register");
+        if constexpr (index == 0) return cpu.B;
+        else if constexpr (index == 1) return cpu.C;
+        else if constexpr (index == 2) return cpu.D;
+        else if constexpr (index == 3) return cpu.E;
+        else if constexpr (index == 4) return cpu.H;
+        else if constexpr (index == 5) return cpu.L;
+        else return cpu.A;
+    }
+
+
+    template <int b>
+    void BIT_b_n(Hardware::CPU& cpu, U8 u8) {
+        cpu.set_flag(Hardware::CPU::Flag::ZERO, (u8 & (1 << b)) == 0);
+        cpu.set_flag(Hardware::CPU::Flag::SUB, false);
+        cpu.set_flag(Hardware::CPU::Flag::HALF_CARRY, true);
+    }
+
+
+    // Bits 3-7 of a prefixed opcode select the operation, with bits 3-5 doubling as the bit index of BIT, RES and SET
+    template <int opcode>
+    void CB_n(Hardware::CPU& cpu, U8& u8) {
+        constexpr int b = opcode >> 3 & 7;
+
+        if constexpr (opcode >= 0xC0) u8 |= 1 << b;
+        else if constexpr (opcode >= 0x80) u8 &= ~(1 << b);
+        else if constexpr (opcode >= 0x40) BIT_b_n<b>(cpu, u8);
+        else if constexpr (b == 0) RLC_n(cpu, u8);
+        else if constexpr (b == 1) RRC_n(cpu, u8);
+        else if constexpr (b == 2) RL_n(cpu, u8);
+        else if constexpr (b == 3) RR_n(cpu, u8);
+        else if constexpr (b == 4) SLA_n(cpu, u8);
+        else if constexpr (b == 5) SRA_n(cpu, u8);
+        else if constexpr (b == 6) SWAP_n(cpu, u8);
+        else SRL_n(cpu, u8);
+    }
+
+
+    // Each of the 256 prefixed opcodes gets its own handler with the operation, bit and operand fixed at compile time
+    // Bits 0-2 select the operand, where (HL) takes 16 cycles to read and write back, or 12 cycles for BIT which only reads
+    template <int opcode>
+    int CB_opcode(Hardware::CPU& cpu) {
+        constexpr int b = opcode >> 3 & 7;
+
+        if constexpr ((opcode & 7) != 6) {
+            CB_n<opcode>(cpu, get_register<opcode & 7>(cpu));
+            return 8;
+        }
+        else if constexpr (opcode >= 0x40 && opcode < 0x80) {
+            BIT_b_n<b>(cpu, cpu.mmu.read_u8(cpu.HL));
+            return 12;
+        }
+        else {
+            U16 hl_pointer = cpu.HL;
+            U8 u8 = cpu.mmu.read_u8(hl_pointer);
+            CB_n<opcode>(cpu, u8);
+            cpu.mmu.write_u8(hl_pointer, u8);
+            return 16;
+        }
+    }
 };
\ No newline at end of file
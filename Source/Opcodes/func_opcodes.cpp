@@ -5,21 +5,34 @@
 
 
 namespace Opcodes {
-    int PUSH_rr(Hardware::CPU& cpu, Hardware::CPU::CombinedRegister combined_register) {
-        cpu.push_onto_stack(cpu.read_combined_register(combined_register));
+    int PUSH_rr(Hardware::CPU& cpu, U16 combined_register) {
+        cpu.push_onto_stack(combined_register);
         return 16;
     }
 
 
-    int POP_rr(Hardware::CPU& cpu, Hardware::CPU::CombinedRegister combined_register) {;
-        cpu.write_combined_register(combined_register, cpu.pop_off_stack());
+    int PUSH_AF(Hardware::CPU& cpu) {
+        cpu.push_onto_stack(cpu.read_AF());
+        return 16;
+    }
+
+
+    int POP_rr(Hardware::CPU& cpu, U16& combined_register) {
+        combined_register = cpu.pop_off_stack();
+        return 12;
+    }
+
+
+    int POP_AF(Hardware::CPU& cpu) {
+        cpu.write_AF(cpu.pop_off_stack());
         return 12;
     }
 
 
     int CALL_u16(Hardware::CPU& cpu) {
-        cpu.push_onto_stack(cpu.program_counter + 2);
-        cpu.program_counter = cpu.mmu.read_u16(cpu.program_counter);
+        U16 address = cpu.fetch_u16();
+        cpu.push_onto_stack(cpu.program_counter);
+        cpu.program_counter = address;
         return 24;
     }
 
@@ -10,8 +10,10 @@ typedef unsigned short U16;
 
 
 namespace Opcodes {
-    int PUSH_rr(Hardware::CPU& cpu, Hardware::CPU::CombinedRegister combined_register);
-    int POP_rr(Hardware::CPU& cpu, Hardware::CPU::CombinedRegister combined_register);
+    int PUSH_rr(Hardware::CPU& cpu, U16 combined_register);
+    int PUSH_AF(Hardware::CPU& cpu);
+    int POP_rr(Hardware::CPU& cpu, U16& combined_register);
+    int POP_AF(Hardware::CPU& cpu);
     int CALL_u16(Hardware::CPU& cpu);
     int CALL_cc_u16(Hardware::CPU& cpu, Hardware::CPU::FlagCondition flag_condition);
     int RET(Hardware::CPU& cpu);
@@ -8,13 +8,13 @@
 
 namespace Opcodes {
     int JP_u16(Hardware::CPU& cpu) {
-        cpu.program_counter = cpu.mmu.read_u16(cpu.program_counter);
+        cpu.program_counter = cpu.fetch_u16();
         return 16;
     }
 
 
     int JP_HL(Hardware::CPU& cpu) {
-        cpu.program_counter = cpu.read_combined_register(cpu.HL);
+        cpu.program_counter = cpu.HL;
         return 4;
     }
 
@@ -31,12 +31,8 @@ namespace Opcodes {
 
 
     int JR_s8(Hardware::CPU& cpu) {
-        U8 s8 = cpu.mmu.read_u8(cpu.program_counter);
-        cpu.program_counter++;
-        std::tuple<U16, bool, bool> result;
-        if (Utilities::get_bit_u8(s8, 7)) result = add_u16(cpu.program_counter, (U16)s8 | 0xFF00, 7, 3);
-        else result = add_u16(cpu.program_counter, s8, 7, 3);
-        cpu.program_counter = std::get<0>(result);
+        U8 s8 = cpu.fetch();
+        cpu.program_counter += (signed char)s8;
         return 12;
     }
 
@@ -15,8 +15,8 @@ namespace Opcodes {
     int LD_r_ptr_HL(Hardware::CPU& cpu, U8& reg);
     int LD_ptr_HL_r(Hardware::CPU& cpu, U8 reg);
     int LD_ptr_HL_u8(Hardware::CPU& cpu);
-    int LD_A_ptr_rr(Hardware::CPU& cpu, Hardware::CPU::CombinedRegister combined_register);
-    int LD_ptr_rr_A(Hardware::CPU& cpu, Hardware::CPU::CombinedRegister combined_register);
+    int LD_A_ptr_rr(Hardware::CPU& cpu, U16 combined_register);
+    int LD_ptr_rr_A(Hardware::CPU& cpu, U16 combined_register);
     int LD_A_ptr_u16(Hardware::CPU& cpu);
     int LD_ptr_u16_A(Hardware::CPU& cpu);
     int LDH_A_ptr_C(Hardware::CPU& cpu);
@@ -27,7 +27,7 @@ namespace Opcodes {
     int LDD_ptr_HL_A(Hardware::CPU& cpu);
     int LDI_A_ptr_HL(Hardware::CPU& cpu);
     int LDI_ptr_HL_A(Hardware::CPU& cpu);
-    int LD_rr_u16(Hardware::CPU& cpu, Hardware::CPU::CombinedRegister combined_register);
+    int LD_rr_u16(Hardware::CPU& cpu, U16& combined_register);
     int LD_SP_u16(Hardware::CPU& cpu);
     int LD_ptr_u16_SP(Hardware::CPU& cpu);
     int LD_SP_HL(Hardware::CPU& cpu);
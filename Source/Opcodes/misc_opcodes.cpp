@@ -1,5 +1,6 @@
 #include "misc_opcodes.hpp"
 #include "../Hardware/cpu.hpp"
+#include "opcodes_helper.hpp"
 
 
 namespace Opcodes {
@@ -42,22 +43,10 @@ namespace Opcodes {
 
     //  I received help on the DAA algorithm from this page: https://blog.ollien.com/posts/gb-daa/
     int DAA(Hardware::CPU& cpu) {
-        if (cpu.get_flag(Hardware::CPU::Flag::SUB)) {
-            if (cpu.get_flag(Hardware::CPU::Flag::CARRY)) cpu.A -= 0x60;
-            if (cpu.get_flag(Hardware::CPU::Flag::HALF_CARRY)) cpu.A -= 6;
-        }
-
-        else {
-            if (cpu.get_flag(Hardware::CPU::Flag::CARRY) || cpu.A > 0x99) {
-                cpu.set_flag(Hardware::CPU::Flag::CARRY, true);
-                cpu.A += 0x60;
-            }
-
-            if (cpu.get_flag(Hardware::CPU::Flag::HALF_CARRY) || (cpu.A & 0xF) > 9) cpu.A += 6;
-        }
-
-        cpu.set_flag(Hardware::CPU::Flag::ZERO, cpu.A == 0);
-        cpu.set_flag(Hardware::CPU::Flag::HALF_CARRY, false);
+        cpu.evaluate_lazy_flags();
+        U16 result = daa_table[cpu.A << 4 | cpu.F >> 4];
+        cpu.A = result >> 8;
+        cpu.F = result & 0xFF;
         return 4;
     }
 }
\ No newline at end of file
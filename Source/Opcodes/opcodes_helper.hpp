@@ -1,7 +1,7 @@
 #pragma once
 
 #include <cstdint>
-#include <tuple>
+#include <array>
 #include "../Hardware/cpu.hpp"
 
 
@@ -10,11 +10,65 @@ typedef unsigned short U16;
 
 
 namespace Opcodes {
-    std::tuple<U8, bool, bool> add_u8(U8 a, U8 b, int carry_bit, int half_carry_bit);
-    std::tuple<U8, bool, bool> sub_u8(U8 a, U8 b, int half_borrow_bit);
-    std::tuple<U16, bool, bool> add_u16(U16 a, U16 b, int carry_bit, int half_carry_bit);
-    bool check_carry_u8(U8 a, U8 b, int carry_bit);
-    bool check_borrow_u8(U8 a, U8 b, int borrow_bit);
-    bool check_carry_u16(U16 a, U16 b, int carry_bit);
+
+    // Carry out of adding or subtracting two nibbles, indexed by is_subtraction << 9 | carry << 8 | a << 4 | b
+    // This covers ADD, ADC, SUB and SBC, with the carry in being 0 for ADD and SUB
+    constexpr std::array<bool, 1024> generate_nibble_carry_table() {
+        std::array<bool, 1024> table {};
+
+        for (int i = 0; i < 1024; i++) {
+            bool is_subtraction = i >> 9;
+            int carry = (i >> 8) & 1;
+            int a = (i >> 4) & 0xF;
+            int b = i & 0xF;
+            table[i] = is_subtraction ? a < b + carry : a + b + carry > 0xF;
+        }
+
+        return table;
+    }
+
+
+    // Result of DAA for every value of A and the upper nibble of F, stored as A << 8 | F
+    constexpr std::array<U16, 4096> generate_daa_table() {
+        std::array<U16, 4096> table {};
+
+        for (int i = 0; i < 4096; i++) {
+            U8 a = i >> 4;
+            bool is_sub = i & 4;
+            bool is_half_carry = i & 2;
+            bool is_carry = i & 1;
+
+            if (is_sub) {
+                if (is_carry) a -= 0x60;
+                if (is_half_carry) a -= 6;
+            }
+
+            else {
+                if (is_carry || a > 0x99) {
+                    is_carry = true;
+                    a += 0x60;
+                }
+
+                if (is_half_carry || (a & 0xF) > 9) a += 6;
+            }
+
+            table[i] = a << 8 | (a == 0) << 7 | is_sub << 6 | is_carry << 4;
+        }
+
+        return table;
+    }
+
+
+    inline constexpr std::array<bool, 1024> nibble_carry_table = generate_nibble_carry_table();
+    inline constexpr std::array<U16, 4096> daa_table = generate_daa_table();
+
+
+    // The carry out of a byte is the carry out of its high nibbles, with the half carry as their carry in
+    constexpr bool check_half_carry_u8(U8 a, U8 b, bool carry) {return nibble_carry_table[carry << 8 | (a & 0xF) << 4 | (b & 0xF)];}
+    constexpr bool check_carry_u8(U8 a, U8 b, bool carry) {return nibble_carry_table[check_half_carry_u8(a, b, carry) << 8 | (a & 0xF0) | b >> 4];}
+    constexpr bool check_half_borrow_u8(U8 a, U8 b, bool borrow) {return nibble_carry_table[0x200 | borrow << 8 | (a & 0xF) << 4 | (b & 0xF)];}
+    constexpr bool check_borrow_u8(U8 a, U8 b, bool borrow) {return nibble_carry_table[0x200 | check_half_borrow_u8(a, b, borrow) << 8 | (a & 0xF0) | b >> 4];}
+    constexpr bool check_half_carry_u16(U16 a, U16 b) {return (a & 0xFFF) + (b & 0xFFF) > 0xFFF;}
+    constexpr bool check_carry_u16(U16 a, U16 b) {return a + b > 0xFFFF;}
     bool check_flag_condition(Hardware::CPU& cpu, Hardware::CPU::FlagCondition flag_condition);
 };
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include <cctype>
+#include <sstream>
 #include "emulation_state.hpp"
 
 
@@ -47,6 +48,7 @@ namespace UI {
         gameboy.lcd.display(gameboy.window, gameboy.selected_palette);
         display_full_screen_black_bars();
         display_fps();
+        display_watchpoint_report();
         apply_screen_fade();
         gameboy.window.display();
     }
@@ -73,4 +75,18 @@ namespace UI {
         if (gameboy.lcd.is_retro_mode_enabled) bottom_black_bar_position = bottom_black_bar_position + Utilities::Vector(0, 1);
         gameboy.renderer.draw_rectangle(gameboy.window, bottom_black_bar_position, gameboy.lcd.scale_factor * gameboy.lcd.width + 1, gameboy.lcd.scale_factor * gameboy.lcd.gap_height, false, sf::Color::Black);
     }
+
+
+    // Shown along the bottom of the LCD while emulation is stopped at a watchpoint, which is resumed from the pause menu
+    void EmulationState::display_watchpoint_report() {
+        if (!gameboy.mmu.watchpoints.is_hit) return;
+        Utilities::Vector position = gameboy.lcd.position + Utilities::Vector(0, gameboy.lcd.height - 20);
+        gameboy.renderer.draw_rectangle(gameboy.window, position * gameboy.lcd.scale_factor, gameboy.lcd.scale_factor * gameboy.lcd.width, gameboy.lcd.scale_factor * 20, false, (*gameboy.selected_palette)[3]);
+        std::stringstream report(gameboy.watchpoint_report);
+        std::string line;
+
+        for (int i = 0; std::getline(report, line); i++) {
+            gameboy.renderer.draw_text(gameboy.window, (position + Utilities::Vector(3, 4 + i * 6)) * gameboy.lcd.scale_factor, line, gameboy.font, gameboy.lcd.scale_factor * 3, false, (*gameboy.selected_palette)[0]);
+        }
+    }
 }
\ No newline at end of file
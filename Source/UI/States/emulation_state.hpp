@@ -14,5 +14,6 @@ namespace UI {
         void perform_logic() override;
         void render() override;
         void display_full_screen_black_bars();
+        void display_watchpoint_report();
     };
 }
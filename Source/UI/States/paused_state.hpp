@@ -9,6 +9,7 @@ namespace UI {
     public:
         PausedState(Gameboy& _gameboy);
         void configure_ui_elements() override;
+        void resume();
         void return_to_home();
     };
 }
@@ -3,10 +3,15 @@
 #include <string>
 #include <fstream>
 #include <iostream>
+#include <sstream>
+#include <iomanip>
 #include "gameboy.hpp"
 #include "Utilities/misc.hpp"
 
 
+const std::array<std::string, 3> watchpoint_types = {"READ", "WRITE", "EXECUTE"}; // Keys of the watchpoint lists in the settings, indexed by Watchpoints::Type
+
+
 // Houses all Gameboy components/configurations, handling the emulation and loading/storing settings
 Gameboy::Gameboy(std::string _exe_path) :
     exe_path(_exe_path),
@@ -15,6 +20,7 @@ Gameboy::Gameboy(std::string _exe_path) :
     full_screen_mode(sf::VideoMode::getFullscreenModes()[0]),
     windowed_mode(sf::VideoMode(0, 0)),
     cpu(mmu),
+    cartridge(timer),
     ppu(mmu, lcd, cpu),
     timer(mmu, cpu),
     joypad(cpu),
@@ -27,11 +33,17 @@ Gameboy::Gameboy(std::string _exe_path) :
 
 
 Gameboy::~Gameboy() {
+    cartridge.save_ram(); // Saved here while the timer still exists, as the cartridge is destroyed after it
+    mmu.bus_tracer.stop();
+    cpu.idle_loop_detector.print_report();
+    if (cpu.opcode_profiler.is_enabled) cpu.opcode_profiler.write_table(SUPERINSTRUCTION_TABLE_PATH, 16); // The table in the source tree, which the build includes
     save_settings();
 }
 
 
 void Gameboy::reset() {
+    cpu.idle_loop_detector.print_report();
+    mmu.bus_tracer.stop();
     cpu.reset();
     mmu.reset();
     ppu.reset();
@@ -41,12 +53,12 @@ void Gameboy::reset() {
     joypad.reset();
 
     if (is_bootstrap_enabled) {
-        mmu.is_bootstrap_enabled = true;
+        mmu.set_bootstrap_enabled(true);
         cpu.program_counter = 0;
         return;
     }
 
-    mmu.is_bootstrap_enabled = false;
+    mmu.set_bootstrap_enabled(false);
     cpu.program_counter = 0x100;
 }
 
@@ -54,10 +66,12 @@ void Gameboy::reset() {
 void Gameboy::insert_rom(std::string rom_path) {
     reset();
     cartridge.insert(rom_path);
+    if (mmu.bus_tracer.is_enabled) mmu.bus_tracer.start(exe_path + "\\bus_trace.bin");
 }
 
 
 void Gameboy::emulate() {
+    if (mmu.watchpoints.is_hit) return; // Emulation stays stopped until the watchpoint is resumed
 
     // Calculates the ticks threshold for the current frame
     // This makes sure the components run at the desired emulation speed regardless of the FPS
@@ -66,17 +80,12 @@ void Gameboy::emulate() {
     int ticks_per_second = (cpu.clock_speed * emulation_speed) / 100;
     int ticks_per_frame = fps > 5 ? ticks_per_second / fps : ticks_per_second / target_fps;
 
-    // Components are clocked by the ticks of the CPU's last instruction
-    // This iterates until the CPU's ticks threshold is reached for the current frame
-    while (cpu.ticks < ticks_per_frame) {
-        int last_instruction_ticks = cpu.run();
-        cpu.ticks += last_instruction_ticks;
-        ppu.run(last_instruction_ticks);
-        timer.run(last_instruction_ticks);
-        cpu.handle_interrupts();
+    if (!cpu.run_frame(ticks_per_frame)) {
+        watchpoint_report = mmu.watchpoints.get_report();
+        return;
     }
 
-    cpu.ticks -= ticks_per_frame;
+    cartridge.update_save();
 }
 
 
@@ -144,11 +153,23 @@ void Gameboy::load_settings() {
         settings_file >> settings_json;
         emulation_speed = settings_json["EMULATION_SPEED"];
         is_bootstrap_enabled = settings_json["IS_BOOTSTRAP_ENABLED"];
+        mmu.bus_tracer.is_enabled = settings_json["IS_BUS_TRACE_ENABLED"];
         target_fps = settings_json["TARGET_FPS"];
         is_display_fps_enabled = settings_json["IS_DISPLAY_FPS_ENABLED"];
         lcd.scale_factor = settings_json["SCALE_FACTOR"];
         lcd.is_retro_mode_enabled = settings_json["IS_RETRO_MODE_ENABLED"];
         lcd.frame_blend_strength = settings_json["FRAME_BLEND_STRENGTH"];
+        cpu.is_jit_enabled = settings_json["IS_JIT_ENABLED"];
+        cpu.opcode_profiler.is_enabled = settings_json["IS_OPCODE_PROFILER_ENABLED"];
+        mmu.watchpoints.clear();
+
+        // Watchpoints are listed under their type as hex addresses, e.g. "0xC000"
+        for (int type = Hardware::Watchpoints::READ; type <= Hardware::Watchpoints::EXECUTE; type++) {
+            for (const std::string& address : settings_json["WATCHPOINTS"][watchpoint_types[type]]) {
+                mmu.watchpoints.add((Hardware::Watchpoints::Type)type, std::stoi(address, nullptr, 16));
+            }
+        }
+
         palettes.resize(settings_json["NUMBER_OF_PALETTES"]);
 
         for (int i = 0; i < palettes.size(); i++) {
@@ -202,13 +223,26 @@ void Gameboy::save_settings() {
         std::ofstream settings_file(exe_path + "\\Assets\\settings.json");
         settings_json["EMULATION_SPEED"] = emulation_speed;
         settings_json["IS_BOOTSTRAP_ENABLED"] = is_bootstrap_enabled;
+        settings_json["IS_BUS_TRACE_ENABLED"] = mmu.bus_tracer.is_enabled;
         settings_json["TARGET_FPS"] = target_fps;
         settings_json["IS_DISPLAY_FPS_ENABLED"] = is_display_fps_enabled;
         settings_json["SCALE_FACTOR"] = lcd.scale_factor;
         settings_json["IS_RETRO_MODE_ENABLED"] = lcd.is_retro_mode_enabled;
         settings_json["FRAME_BLEND_STRENGTH"] = lcd.frame_blend_strength;
+        settings_json["IS_JIT_ENABLED"] = cpu.is_jit_enabled;
+        settings_json["IS_OPCODE_PROFILER_ENABLED"] = cpu.opcode_profiler.is_enabled;
         settings_json["NUMBER_OF_PALETTES"] = palettes.size();
 
+        for (int type = Hardware::Watchpoints::READ; type <= Hardware::Watchpoints::EXECUTE; type++) {
+            settings_json["WATCHPOINTS"][watchpoint_types[type]] = nlohmann::json::array();
+
+            for (U16 address : mmu.watchpoints.addresses[type]) {
+                std::stringstream hex_address;
+                hex_address << "0x" << std::hex << std::uppercase << std::setfill('0') << std::setw(4) << address;
+                settings_json["WATCHPOINTS"][watchpoint_types[type]].push_back(hex_address.str());
+            }
+        }
+
         for (int i = 0; i < palettes.size(); i++) {
             for (int j = 0; j < 4; j++) {
                 settings_json["PALETTES"][std::to_string(i)][std::to_string(j)]["R"] = (*palettes[i])[j].r;
@@ -250,11 +284,15 @@ void Gameboy::save_settings() {
 void Gameboy::restore_default_settings() {
     emulation_speed = 100;
     is_bootstrap_enabled = true;
+    mmu.bus_tracer.is_enabled = false;
     target_fps = 60;
     is_display_fps_enabled = true;
     lcd.scale_factor = lcd.full_screen_scale_factor;
     lcd.is_retro_mode_enabled = true;
     lcd.frame_blend_strength = 1;
+    cpu.is_jit_enabled = false;
+    cpu.opcode_profiler.is_enabled = false;
+    mmu.watchpoints.clear();
     palettes.clear();
 
     palettes.push_back(std::make_shared<std::array<sf::Color, 4>>(std::array<sf::Color, 4>{
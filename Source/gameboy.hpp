@@ -53,6 +53,7 @@ public:
     Hardware::PPU ppu;
     Hardware::MMU mmu;
     Hardware::Timer timer;
+    std::string watchpoint_report;
     std::vector<std::string> roms;
     nlohmann::json key_binds;
     nlohmann::json controller_binds;
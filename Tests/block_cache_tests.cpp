@@ -0,0 +1,108 @@
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "test_system.hpp"
+
+
+// Checks that the block cache follows ROM bank switches and code written over in work RAM and high RAM
+// A small MBC1 ROM is written out which calls the same address in two ROM banks, then rewrites and calls again routines copied into RAM
+// Each result is only correct if the cache has replayed the code currently mapped, rather than a block cached beforehand
+
+
+static TestSystem& test_system = TestSystem::get_instance();
+static int total_failures = 0;
+
+
+// Calls 0x4000 in banks 1 and 2 twice over, then copies INC A; RET into work RAM and high RAM, calling each before and after its INC A is changed to DEC A
+// The stack is moved out of high RAM, so that the calls themselves don't write to the page holding the high RAM routine
+static const std::vector<U8> program = {
+    0x31, 0xFF, 0xDF, // LD SP, 0xDFFF
+    0x3E, 0x01, 0xEA, 0x00, 0x20, 0xCD, 0x00, 0x40, 0x47, // Select bank 1, CALL 0x4000, LD B, A
+    0x3E, 0x02, 0xEA, 0x00, 0x20, 0xCD, 0x00, 0x40, 0x4F, // Select bank 2, CALL 0x4000, LD C, A
+    0x3E, 0x01, 0xEA, 0x00, 0x20, 0xCD, 0x00, 0x40, 0x57, // Select bank 1, CALL 0x4000, LD D, A
+    0x3E, 0x02, 0xEA, 0x00, 0x20, 0xCD, 0x00, 0x40, 0x5F, // Select bank 2, CALL 0x4000, LD E, A
+    0x21, 0x00, 0xC0, 0x36, 0x3C, 0x23, 0x36, 0xC9, // LD HL, 0xC000, LD (HL), INC A, INC HL, LD (HL), RET
+    0x3E, 0x10, 0xCD, 0x00, 0xC0, 0xEA, 0x00, 0xD0, // LD A, 0x10, CALL 0xC000, LD (0xD000), A
+    0x3E, 0x3D, 0xEA, 0x00, 0xC0, // LD A, DEC A, LD (0xC000), A
+    0x3E, 0x10, 0xCD, 0x00, 0xC0, 0xEA, 0x01, 0xD0, // LD A, 0x10, CALL 0xC000, LD (0xD001), A
+    0x3E, 0x3C, 0xE0, 0x80, 0x3E, 0xC9, 0xE0, 0x81, // LD A, INC A, LDH (0x80), A, LD A, RET, LDH (0x81), A
+    0x3E, 0x10, 0xCD, 0x80, 0xFF, 0xEA, 0x02, 0xD0, // LD A, 0x10, CALL 0xFF80, LD (0xD002), A
+    0x3E, 0x3D, 0xE0, 0x80, // LD A, DEC A, LDH (0x80), A
+    0x3E, 0x10, 0xCD, 0x80, 0xFF, 0xEA, 0x03, 0xD0, // LD A, 0x10, CALL 0xFF80, LD (0xD003), A
+    0x18, 0xFE // JR -2
+};
+
+
+static const int program_address = 0x150;
+static const U16 end_address = program_address + program.size() - 2;
+
+
+static std::string write_rom() {
+    std::vector<char> rom(0x10000, 0);
+    rom[0x100] = 0x00; // NOP
+    rom[0x101] = (char)0xC3; // JP 0x0150
+    rom[0x102] = program_address & 0xFF;
+    rom[0x103] = program_address >> 8;
+    rom[0x147] = 0x01; // MBC1
+    rom[0x148] = 0x01; // 4 ROM banks
+    std::copy(program.begin(), program.end(), rom.begin() + program_address);
+
+    // LD A, 0xB0, then an INC A for each bank number and RET, at the start of each switchable bank
+    // The banks must hold different instructions, as a stale block would still read the current bank's operands
+    for (int bank = 1; bank < 4; bank++) {
+        int address = bank * 0x4000;
+        rom[address++] = 0x3E;
+        rom[address++] = (char)0xB0;
+        for (int i = 0; i < bank; i++) rom[address++] = 0x3C;
+        rom[address] = (char)0xC9;
+    }
+
+    std::string file_path = (std::filesystem::temp_directory_path() / "antboy_block_cache_tests.gb").string();
+    std::ofstream file(file_path, std::ios::binary);
+    file.write(rom.data(), rom.size());
+    return file_path;
+}
+
+
+static void check(bool is_passed, std::string name, int value) {
+    if (is_passed) return;
+    total_failures++;
+    std::cerr << "Error: " << name << " gave 0x" << std::hex << std::uppercase << std::setfill('0') << std::setw(2) << value << std::dec << std::endl;
+}
+
+
+int main() {
+    Hardware::CPU& cpu = test_system.cpu;
+    Hardware::MMU& mmu = test_system.mmu;
+    std::string file_path = write_rom();
+    test_system.insert_rom(file_path);
+
+    for (int i = 0; i < 1000 && cpu.program_counter != end_address; i++) cpu.run(1000);
+    std::filesystem::remove(file_path);
+
+    if (cpu.program_counter != end_address) {
+        std::cerr << "Error: The program didn't reach its end" << std::endl;
+        return 1;
+    }
+
+    check(cpu.B == 0xB1, "The first call to bank 1", cpu.B);
+    check(cpu.C == 0xB2, "The first call to bank 2", cpu.C);
+    check(cpu.D == 0xB1, "The second call to bank 1", cpu.D);
+    check(cpu.E == 0xB2, "The second call to bank 2", cpu.E);
+    check(mmu.read_u8(0xD000) == 0x11, "The work RAM routine", mmu.read_u8(0xD000));
+    check(mmu.read_u8(0xD001) == 0x0F, "The rewritten work RAM routine", mmu.read_u8(0xD001));
+    check(mmu.read_u8(0xD002) == 0x11, "The high RAM routine", mmu.read_u8(0xD002));
+    check(mmu.read_u8(0xD003) == 0x0F, "The rewritten high RAM routine", mmu.read_u8(0xD003));
+
+    // Both banks' copies of 0x4000 must have been cached, otherwise the bank switches weren't tested
+    std::vector<Hardware::BlockCache::BlockSet>& rom_block_sets = cpu.block_cache.rom_block_sets;
+    bool are_banks_cached = rom_block_sets.size() > 2 && rom_block_sets[1].count(0x4000) > 0 && rom_block_sets[2].count(0x4000) > 0;
+    check(are_banks_cached, "Caching 0x4000 in banks 1 and 2", are_banks_cached);
+
+    if (total_failures > 0) std::cerr << total_failures << " block cache checks failed" << std::endl;
+    return total_failures > 0;
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "test_system.hpp"
+
+
+// Checks that a bus trace recorded over a few frames reads back through the record layout the trace analyzer uses
+// The file must hold the header and a whole number of records, with cycles that never go backwards
+// Replaying the CPU's recorded writes to work RAM, echo RAM and high RAM over their contents from the start must give their contents at the end
+
+
+static TestSystem& test_system = TestSystem::get_instance();
+static const int total_frames = 60;
+static int total_failures = 0;
+
+
+static void check(bool is_passed, std::string rom_name, std::string message) {
+    if (is_passed) return;
+    total_failures++;
+    std::cerr << "Error: " << rom_name << ": " << message << std::endl;
+}
+
+
+static void test_rom(std::string rom_name) {
+    Hardware::MMU& mmu = test_system.mmu;
+    std::string trace_path = (std::filesystem::temp_directory_path() / "antboy_bus_trace_tests.bin").string();
+    test_system.insert_rom(ROM_DIRECTORY + rom_name);
+    std::vector<U8> work_ram(mmu.work_ram.get(), mmu.work_ram.get() + 8192);
+    std::vector<U8> high_ram(mmu.high_ram.get(), mmu.high_ram.get() + 127);
+    mmu.bus_tracer.start(trace_path);
+
+    for (int frame = 0; frame < total_frames; frame++) {
+        test_system.update_input(frame);
+        test_system.cpu.run_frame(TestSystem::ticks_per_frame);
+    }
+
+    unsigned long long total_cycles = mmu.bus_tracer.cycle;
+    mmu.bus_tracer.stop();
+    size_t file_size = std::filesystem::file_size(trace_path);
+    std::ifstream file(trace_path, std::ios::binary);
+    char magic[4];
+    uint32_t version = 0;
+    file.read(magic, 4);
+    file.read((char*)&version, 4);
+    check(file && std::memcmp(magic, Hardware::BusTracer::magic, 4) == 0 && version == Hardware::BusTracer::version, rom_name, "The header doesn't match");
+    check(file_size > 8 && (file_size - 8) % sizeof(Hardware::BusTracer::Record) == 0, rom_name, "The file doesn't hold a whole number of records");
+
+    std::vector<Hardware::BusTracer::Record> records((file_size - 8) / sizeof(Hardware::BusTracer::Record));
+    file.read((char*)records.data(), records.size() * sizeof(Hardware::BusTracer::Record));
+    check((bool)file, rom_name, "The records couldn't be read back");
+    file.close();
+    std::filesystem::remove(trace_path);
+
+    uint32_t previous_cycle = 0;
+    bool are_flags_known = true;
+    bool are_cycles_ordered = true;
+    int total_cpu_writes = 0;
+    int total_ppu_reads = 0;
+
+    for (Hardware::BusTracer::Record& record : records) {
+        bool is_write = record.flags & 1;
+        int source = record.flags >> 1;
+        are_flags_known &= source <= Hardware::BusTracer::FROM_DMA;
+        are_cycles_ordered &= record.cycle >= previous_cycle && record.cycle <= total_cycles;
+        previous_cycle = record.cycle;
+        if (source == Hardware::BusTracer::FROM_PPU && !is_write) total_ppu_reads++;
+        if (source != Hardware::BusTracer::FROM_CPU || !is_write) continue;
+        total_cpu_writes++;
+        if (record.address >= 0xC000 && record.address < 0xFE00) work_ram[(record.address - 0xC000) & 0x1FFF] = record.u8; // Echo RAM mirrors work RAM
+        else if (record.address >= 0xFF80 && record.address < 0xFFFF) high_ram[record.address - 0xFF80] = record.u8;
+    }
+
+    check(are_flags_known, rom_name, "A record has unknown flags");
+    check(are_cycles_ordered, rom_name, "The records' cycles go backwards or past the end of the trace");
+    check(total_cpu_writes > 0 && total_ppu_reads > 0, rom_name, "The trace is missing CPU writes or PPU reads");
+    check(std::memcmp(work_ram.data(), mmu.work_ram.get(), 8192) == 0, rom_name, "Replaying the trace doesn't give the same work RAM");
+    check(std::memcmp(high_ram.data(), mmu.high_ram.get(), 127) == 0, rom_name, "Replaying the trace doesn't give the same high RAM");
+}
+
+
+int main() {
+    for (std::string rom_name : {"Snake.gb", "Flappy Bird Clone.gb", "Wordle.gb"}) test_rom(rom_name);
+    if (total_failures > 0) std::cerr << total_failures << " bus trace checks failed" << std::endl;
+    return total_failures > 0;
+}
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include "test_system.hpp"
+
+
+// Checks the generated CB-prefixed handlers against the hand-written handlers which they replaced
+// Every prefixed opcode is run on every operand value, with and without the carry flag, from randomised registers
+
+
+static TestSystem& test_system = TestSystem::get_instance();
+static int total_failures = 0;
+
+
+struct State {
+    U8 registers[8]; // B, C, D, E, H, L, (HL), A - following the opcode encoding
+    U8 f;
+};
+
+
+static void set_flag(U8& f, int bit, bool state) {f = state ? f | 1 << bit : f & ~(1 << bit);}
+
+
+// The previous handlers, which were picked by a switch on the opcode and shared a helper for each operation
+// Returns the ticks taken, with (HL) taking 16 ticks and BIT n,(HL) 12 ticks
+static int run_reference(int opcode, State& state) {
+    U8& u8 = state.registers[opcode & 7];
+    int b = opcode >> 3 & 7;
+    bool is_memory = (opcode & 7) == 6;
+
+    if (opcode >= 0xC0) u8 |= 1 << b;
+    else if (opcode >= 0x80) u8 &= ~(1 << b);
+
+    else if (opcode >= 0x40) {
+        set_flag(state.f, 7, (u8 & (1 << b)) == 0);
+        set_flag(state.f, 6, false);
+        set_flag(state.f, 5, true);
+        return is_memory ? 12 : 8;
+    }
+
+    else {
+        bool is_carry_in = state.f & 0x10;
+        bool is_carry_out;
+
+        switch (b) {
+            case 0: is_carry_out = u8 >> 7; u8 = u8 << 1 | u8 >> 7; break; // RLC
+            case 1: is_carry_out = u8 & 1; u8 = u8 >> 1 | (u8 & 1) << 7; break; // RRC
+            case 2: is_carry_out = u8 >> 7; u8 = u8 << 1 | is_carry_in; break; // RL
+            case 3: is_carry_out = u8 & 1; u8 = u8 >> 1 | is_carry_in << 7; break; // RR
+            case 4: is_carry_out = u8 >> 7; u8 <<= 1; break; // SLA
+            case 5: is_carry_out = u8 & 1; u8 = u8 >> 1 | (u8 & 0x80); break; // SRA
+            case 6: is_carry_out = false; u8 = u8 << 4 | u8 >> 4; break; // SWAP
+            default: is_carry_out = u8 & 1; u8 >>= 1; break; // SRL
+        }
+
+        set_flag(state.f, 7, u8 == 0);
+        set_flag(state.f, 6, false);
+        set_flag(state.f, 5, false);
+        set_flag(state.f, 4, is_carry_out);
+    }
+
+    return is_memory ? 16 : 8;
+}
+
+
+// Loads a state into the CPU, with (HL) held in work RAM when it is the operand
+static void load_state(const State& state, bool is_memory) {
+    Hardware::CPU& cpu = test_system.cpu;
+    cpu.B = state.registers[0];
+    cpu.C = state.registers[1];
+    cpu.D = state.registers[2];
+    cpu.E = state.registers[3];
+    cpu.H = state.registers[4];
+    cpu.L = state.registers[5];
+    cpu.write_AF(state.registers[7] << 8 | state.f);
+    if (is_memory) test_system.mmu.write_u8(cpu.HL, state.registers[6]);
+}
+
+
+static State save_state(const State& state, bool is_memory) {
+    Hardware::CPU& cpu = test_system.cpu;
+    U16 af = cpu.read_AF();
+    U8 u8 = is_memory ? test_system.mmu.read_u8(cpu.HL) : state.registers[6];
+    return {{cpu.B, cpu.C, cpu.D, cpu.E, cpu.H, cpu.L, u8, (U8)(af >> 8)}, (U8)(af & 0xFF)};
+}
+
+
+static void check(bool is_passing, int opcode, int operand, const char* message) {
+    if (is_passing) return;
+    if (++total_failures > 20) return;
+    std::cerr << "Error: CB 0x" << std::hex << std::uppercase << std::setw(2) << std::setfill('0') << opcode;
+    std::cerr << " on 0x" << std::setw(2) << operand << std::dec << " - " << message << std::endl;
+}
+
+
+int main() {
+    std::mt19937 random(0x4342);
+
+    for (int opcode = 0; opcode < 256; opcode++) {
+        for (int operand = 0; operand < 256; operand++) {
+            for (int carry = 0; carry < 2; carry++) {
+                bool is_memory = (opcode & 7) == 6;
+                State state;
+                for (U8& u8 : state.registers) u8 = random();
+                state.registers[4] = 0xC0 | (state.registers[4] & 0x1F); // Keeps HL within work RAM
+                state.registers[opcode & 7] = operand;
+                state.f = (random() & 0xE0) | carry << 4;
+                load_state(state, is_memory);
+
+                State expected = state;
+                int expected_ticks = run_reference(opcode, expected);
+                int ticks = test_system.run_opcode(0x100 | opcode);
+                State actual = save_state(state, is_memory);
+
+                check(ticks == expected_ticks, opcode, operand, "ticks differ");
+                check(actual.f == expected.f, opcode, operand, "flags differ");
+                for (int i = 0; i < 8; i++) check(actual.registers[i] == expected.registers[i], opcode, operand, "registers differ");
+            }
+        }
+    }
+
+    if (total_failures > 0) std::cerr << total_failures << " CB opcode checks failed" << std::endl;
+    return total_failures > 0;
+}
\ No newline at end of file
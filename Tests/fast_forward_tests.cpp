@@ -0,0 +1,112 @@
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "test_system.hpp"
+
+
+// Checks that skipping ahead through halt mode and idle loops leaves the system in exactly the state that stepping through them does
+// Each bundled ROM is run once through the interpreter with halt mode taking its 4 tick steps one at a time, and once as normal
+// The state of the system is hashed after every frame, and the two runs must match frame for frame
+
+
+static TestSystem& test_system = TestSystem::get_instance();
+static const int total_frames = 1500;
+static long long total_instructions = 0; // Steps in halt mode count as an instruction each, as they do in last_instruction_count
+
+
+static uint64_t hash_bytes(uint64_t hash, const U8* bytes, int size) {
+    for (int i = 0; i < size; i++) hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    return hash;
+}
+
+
+// The registers, the instructions run and the ticks run over into the next frame, then work RAM, high RAM, OAM and the last completed frame
+static uint64_t hash_state() {
+    Hardware::CPU& cpu = test_system.cpu;
+    U16 registers[6] = {cpu.read_AF(), cpu.BC, cpu.DE, cpu.HL, cpu.program_counter, cpu.stack_pointer};
+    long long counts[2] = {total_instructions, cpu.ticks};
+    uint64_t hash = 14695981039346656037ULL;
+    hash = hash_bytes(hash, (const U8*)registers, sizeof(registers));
+    hash = hash_bytes(hash, (const U8*)counts, sizeof(counts));
+    hash = hash_bytes(hash, test_system.mmu.work_ram.get(), 8192);
+    hash = hash_bytes(hash, test_system.mmu.high_ram.get(), 127);
+    hash = hash_bytes(hash, test_system.ppu.oam.get(), 160);
+    hash = hash_bytes(hash, test_system.lcd.frame_buffers.front().data(), test_system.lcd.frame_buffers.front().size());
+    return hash;
+}
+
+
+template <typename RunInstruction>
+static std::vector<uint64_t> run_rom(std::string rom_path, RunInstruction run_instruction) {
+    std::vector<uint64_t> hashes;
+    test_system.insert_rom(rom_path);
+    total_instructions = 0;
+
+    for (int frame = 0; frame < total_frames; frame++) {
+        test_system.update_input(frame);
+
+        test_system.run_frame([&](int max_skipped_ticks) {
+            int ticks = run_instruction(max_skipped_ticks);
+            total_instructions += test_system.cpu.last_instruction_count;
+            return ticks;
+        });
+
+        hashes.push_back(hash_state());
+    }
+
+    return hashes;
+}
+
+
+static void set_fast_paths_enabled(bool state) {
+    Hardware::CPU& cpu = test_system.cpu;
+    cpu.is_block_cache_enabled = state;
+    cpu.are_superinstructions_enabled = state;
+    cpu.idle_loop_detector.is_enabled = state;
+}
+
+
+int main() {
+    Hardware::CPU& cpu = test_system.cpu;
+    std::vector<std::string> rom_names = {"Snake.gb", "Wordle.gb", "Flappy Bird Clone.gb"};
+    int total_failures = 0;
+    long long total_skips = 0;
+
+    for (std::string& rom_name : rom_names) {
+        set_fast_paths_enabled(false);
+
+        std::vector<uint64_t> stepped_hashes = run_rom(ROM_DIRECTORY + rom_name, [&](int max_skipped_ticks) {
+            if (!cpu.is_halted) return cpu.run(max_skipped_ticks);
+            cpu.last_instruction_count = 1;
+            return 4;
+        });
+
+        set_fast_paths_enabled(true);
+        std::vector<uint64_t> hashes = run_rom(ROM_DIRECTORY + rom_name, [&](int max_skipped_ticks) {return cpu.run(max_skipped_ticks);});
+
+        for (int frame = 0; frame < total_frames; frame++) {
+            if (hashes[frame] == stepped_hashes[frame]) continue;
+            std::cerr << "Error: " << rom_name << " differs from stepping through halt mode and idle loops at frame " << frame << std::endl;
+            total_failures++;
+            break;
+        }
+
+        total_skips += cpu.idle_loop_detector.total_skips;
+    }
+
+    if (total_skips == 0) {
+        std::cerr << "Error: No idle loops were skipped" << std::endl;
+        total_failures++;
+    }
+
+    // The detections are kept for each ROM, so they are still there once the ROM is inserted again
+    test_system.insert_rom(ROM_DIRECTORY + rom_names[0]);
+
+    if (cpu.idle_loop_detector.detected_loops[cpu.idle_loop_detector.get_rom_name()].empty()) {
+        std::cerr << "Error: The idle loops detected in " << rom_names[0] << " were lost when it was inserted again" << std::endl;
+        total_failures++;
+    }
+
+    return total_failures > 0;
+}
\ No newline at end of file
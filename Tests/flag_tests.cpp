@@ -0,0 +1,185 @@
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include "test_system.hpp"
+#include "Opcodes/opcodes_helper.hpp"
+
+
+// Checks the constexpr flag tables against the per-operation flag code which they replaced
+// Every combination of A, the operand and the carry in is run through ADD, ADC, SUB and SBC, along with every input to DAA
+
+
+static TestSystem& test_system = TestSystem::get_instance();
+static int total_failures = 0;
+
+
+struct Flags {
+    bool zero;
+    bool sub;
+    bool half_carry;
+    bool carry;
+};
+
+
+static U8 get_flags_u8(Flags flags) {return flags.zero << 7 | flags.sub << 6 | flags.half_carry << 5 | flags.carry << 4;}
+
+
+// The previous helpers, which found the carry out of a bit by masking off the bits above it
+static bool reference_check_carry(unsigned int a, unsigned int b, int carry_bit) {
+    unsigned int mask = (2u << carry_bit) - 1;
+    return (a & mask) + (b & mask) > mask;
+}
+
+
+static bool reference_check_borrow(unsigned int a, unsigned int b, int borrow_bit) {
+    unsigned int mask = (2u << borrow_bit) - 1;
+    return (a & mask) < (b & mask);
+}
+
+
+// The previous ADD, ADC, SUB and SBC, which added the carry in to the operand first and combined the flags of both steps
+static U8 reference_alu(int operation, U8 a, U8 b, Flags& flags) {
+    bool is_carry_in = (operation == 1 || operation == 3) && flags.carry;
+    bool is_subtraction = operation >= 2;
+    bool is_first_half_carry = reference_check_carry(is_carry_in, b, 3);
+    bool is_first_carry = reference_check_carry(is_carry_in, b, 7);
+    U8 operand = b + is_carry_in;
+    U8 result = is_subtraction ? a - operand : a + operand;
+    bool is_half_carry = is_subtraction ? reference_check_borrow(a, operand, 3) : reference_check_carry(a, operand, 3);
+    bool is_carry = is_subtraction ? reference_check_borrow(a, operand, 7) : reference_check_carry(a, operand, 7);
+    flags.zero = result == 0;
+    flags.sub = is_subtraction;
+    flags.half_carry = is_half_carry || (is_carry_in && is_first_half_carry);
+    flags.carry = is_carry || (is_carry_in && is_first_carry);
+    return result;
+}
+
+
+// The previous DAA, which worked from the flags in F
+static U8 reference_daa(U8 a, Flags& flags) {
+    if (flags.sub) {
+        if (flags.carry) a -= 0x60;
+        if (flags.half_carry) a -= 6;
+    }
+
+    else {
+        if (flags.carry || a > 0x99) {
+            flags.carry = true;
+            a += 0x60;
+        }
+
+        if (flags.half_carry || (a & 0xF) > 9) a += 6;
+    }
+
+    flags.zero = a == 0;
+    flags.half_carry = false;
+    return a;
+}
+
+
+static void check(bool is_passing, const char* name, int a, int b, int f) {
+    if (is_passing) return;
+    if (++total_failures > 20) return;
+    std::cerr << "Error: " << name << " mismatch for A=0x" << std::hex << std::setw(2) << std::setfill('0') << a;
+    std::cerr << " operand=0x" << std::setw(2) << b << " F=0x" << std::setw(2) << f << std::dec << std::endl;
+}
+
+
+static void test_helpers() {
+    for (int a = 0; a < 256; a++) {
+        for (int b = 0; b < 256; b++) {
+            for (int carry = 0; carry < 2; carry++) {
+                check(Opcodes::check_half_carry_u8(a, b, carry) == ((a & 0xF) + (b & 0xF) + carry > 0xF), "check_half_carry_u8", a, b, carry << 4);
+                check(Opcodes::check_carry_u8(a, b, carry) == (a + b + carry > 0xFF), "check_carry_u8", a, b, carry << 4);
+                check(Opcodes::check_half_borrow_u8(a, b, carry) == ((a & 0xF) < (b & 0xF) + carry), "check_half_borrow_u8", a, b, carry << 4);
+                check(Opcodes::check_borrow_u8(a, b, carry) == (a < b + carry), "check_borrow_u8", a, b, carry << 4);
+            }
+        }
+    }
+
+    // The 16-bit helpers are checked on every value of a against a spread of values of b
+    for (int a = 0; a < 0x10000; a++) {
+        for (int b = 0; b < 0x10000; b += 0x101) {
+            check(Opcodes::check_half_carry_u16(a, b) == reference_check_carry(a, b, 11), "check_half_carry_u16", a, b, 0);
+            check(Opcodes::check_carry_u16(a, b) == reference_check_carry(a, b, 15), "check_carry_u16", a, b, 0);
+        }
+    }
+}
+
+
+// Runs ADD A,B, ADC A,B, SUB B and SBC A,B through the CPU, so the lazy flags are checked along with the tables
+// Each case is also run after INC D, so that ADC and SBC take their carry in from flags which are still pending
+static void test_alu_opcodes() {
+    const char* names[4] = {"ADD", "ADC", "SUB", "SBC"};
+    Hardware::CPU& cpu = test_system.cpu;
+
+    for (int operation = 0; operation < 4; operation++) {
+        for (int a = 0; a < 256; a++) {
+            for (int b = 0; b < 256; b++) {
+                for (int carry = 0; carry < 2; carry++) {
+                    Flags flags = {false, false, false, (bool)carry};
+                    U8 result = reference_alu(operation, a, b, flags);
+
+                    for (int is_pending = 0; is_pending < 2; is_pending++) {
+                        cpu.write_AF(a << 8 | carry << 4);
+                        cpu.B = b;
+                        if (is_pending) test_system.run_opcode(0x14);
+                        test_system.run_opcode(0x80 + operation * 8);
+                        check(cpu.read_AF() == (result << 8 | get_flags_u8(flags)), names[operation], a, b, carry << 4);
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+// INC and DEC keep the carry flag, which they take from the pending flags of the ALU operation before them
+static void test_carry_through_inc_dec() {
+    const char* names[4] = {"INC/DEC after ADD", "INC/DEC after ADC", "INC/DEC after SUB", "INC/DEC after SBC"};
+    Hardware::CPU& cpu = test_system.cpu;
+
+    for (int operation = 0; operation < 4; operation++) {
+        for (int a = 0; a < 256; a++) {
+            for (int b = 0; b < 256; b++) {
+                for (int carry = 0; carry < 2; carry++) {
+                    Flags flags = {false, false, false, (bool)carry};
+                    reference_alu(operation, a, b, flags);
+                    cpu.write_AF(a << 8 | carry << 4);
+                    cpu.B = b;
+                    cpu.C = a;
+                    test_system.run_opcode(0x80 + operation * 8);
+                    test_system.run_opcode(0x0C); // INC C
+                    test_system.run_opcode(0x0D); // DEC C
+                    U8 f = (U8)(a == 0) << 7 | 1 << 6 | (U8)(((a + 1) & 0xF) == 0) << 5 | flags.carry << 4;
+                    check((cpu.read_AF() & 0xFF) == f, names[operation], a, b, carry << 4);
+                }
+            }
+        }
+    }
+}
+
+
+static void test_daa() {
+    Hardware::CPU& cpu = test_system.cpu;
+
+    for (int a = 0; a < 256; a++) {
+        for (int f = 0; f < 256; f += 0x10) {
+            Flags flags = {(bool)(f & 0x80), (bool)(f & 0x40), (bool)(f & 0x20), (bool)(f & 0x10)};
+            U8 result = reference_daa(a, flags);
+            cpu.write_AF(a << 8 | f);
+            test_system.run_opcode(0x27);
+            check(cpu.read_AF() == (result << 8 | get_flags_u8(flags)), "DAA", a, 0, f);
+        }
+    }
+}
+
+
+int main() {
+    test_helpers();
+    test_alu_opcodes();
+    test_carry_through_inc_dec();
+    test_daa();
+    if (total_failures > 0) std::cerr << total_failures << " flag checks failed" << std::endl;
+    return total_failures > 0;
+}
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <filesystem>
+#include <random>
+#include <vector>
+#include "test_system.hpp"
+
+
+// Runs the recompiler in differential mode over randomly generated blocks of register-only instructions
+// Each block runs natively and then through the interpreter from the same registers, and is dropped back to the interpreter if the two disagree
+// A block left with native instructions but no native code has therefore mismatched
+
+
+static TestSystem& test_system = TestSystem::get_instance();
+static const int block_size = 32;
+static const int first_block_address = 0x150;
+
+
+// The opcodes which only touch the CPU's registers, whether or not the recompiler can translate them
+static std::vector<int> get_register_opcodes() {
+    std::vector<int> opcodes = {0x00, 0x03, 0x07, 0x09, 0x0B, 0x0F, 0x13, 0x17, 0x19, 0x1B, 0x1F, 0x23, 0x27, 0x29, 0x2B, 0x2F, 0x33, 0x37, 0x39, 0x3B, 0x3F};
+
+    for (int opcode = 0x40; opcode < 0xC0; opcode++) {
+        if ((opcode & 7) == 6 || (opcode >= 0x70 && opcode < 0x78)) continue; // (HL) operands
+        opcodes.push_back(opcode);
+    }
+
+    for (int r = 0; r < 8; r++) {
+        if (r == 6) continue;
+        opcodes.push_back(r << 3 | 0x04); // INC r
+        opcodes.push_back(r << 3 | 0x05); // DEC r
+        opcodes.push_back(r << 3 | 0x06); // LD r, u8
+        opcodes.push_back(r << 3 | 0xC6); // ALU A, u8
+    }
+
+    return opcodes;
+}
+
+
+static int get_opcode_length(int opcode) {return (opcode & 0xC7) == 0x06 || (opcode & 0xC7) == 0xC6 ? 2 : 1;}
+
+
+// Each block is a run of random instructions followed by a jump back to its start, so it is hot as soon as it loops
+static std::string write_rom(std::mt19937& random, int total_blocks) {
+    std::vector<int> opcodes = get_register_opcodes();
+    std::vector<char> rom(0x8000, 0);
+
+    for (int i = 0; i < total_blocks; i++) {
+        int address = first_block_address + i * block_size;
+        int end_address = address + block_size - 3;
+        int total_instructions = 2 + random() % 12;
+
+        for (int j = 0; j < total_instructions && address + 2 <= end_address; j++) {
+            int opcode = opcodes[random() % opcodes.size()];
+            rom[address++] = opcode;
+            if (get_opcode_length(opcode) == 2) rom[address++] = random();
+        }
+
+        int start_address = first_block_address + i * block_size;
+        rom[address++] = (char)0xC3; // JP u16
+        rom[address++] = start_address & 0xFF;
+        rom[address++] = start_address >> 8;
+    }
+
+    std::string file_path = (std::filesystem::temp_directory_path() / "antboy_jit_tests.gb").string();
+    std::ofstream file(file_path, std::ios::binary);
+    file.write(rom.data(), rom.size());
+    return file_path;
+}
+
+
+int main() {
+    Hardware::CPU& cpu = test_system.cpu;
+
+    if (!cpu.jit.is_available) {
+        std::cout << "The recompiler isn't available on this platform, skipping" << std::endl;
+        return 0;
+    }
+
+    std::mt19937 random(0x4A4954);
+    int total_blocks = (0x8000 - first_block_address) / block_size;
+    std::string file_path = write_rom(random, total_blocks);
+    test_system.cartridge.insert(file_path);
+    cpu.is_jit_enabled = true;
+    cpu.jit.is_differential_testing_enabled = true;
+    cpu.jit.hot_block_threshold = 1;
+    cpu.idle_loop_detector.is_enabled = false;
+    int total_compiled_blocks = 0;
+    int total_mismatches = 0;
+
+    for (int i = 0; i < total_blocks; i++) {
+        U16 start_address = first_block_address + i * block_size;
+        cpu.program_counter = start_address;
+
+        // Each pass around the loop starts from the registers the previous pass left, so every block is checked from many states
+        cpu.write_AF(random() & 0xFFF0);
+        cpu.BC = random();
+        cpu.DE = random();
+        cpu.HL = random();
+        for (int j = 0; j < 256; j++) cpu.run(1000);
+
+        Hardware::BlockCache::BasicBlock* block = cpu.block_cache.find_block(start_address);
+        if (block == nullptr || block->native_instructions == 0) continue;
+        total_compiled_blocks++;
+
+        if (block->native_code == nullptr) {
+            total_mismatches++;
+            std::cerr << "Error: Native code differs from the interpreter for:" << std::hex << std::uppercase << std::setfill('0');
+            for (U8 u8 : block->bytes) std::cerr << " " << std::setw(2) << (int)u8;
+            std::cerr << std::dec << std::endl;
+        }
+    }
+
+    std::filesystem::remove(file_path);
+    std::cout << total_compiled_blocks << " of " << total_blocks << " blocks compiled" << std::endl;
+
+    if (total_compiled_blocks == 0) {
+        std::cerr << "Error: No blocks were compiled" << std::endl;
+        return 1;
+    }
+
+    if (total_mismatches > 0) std::cerr << total_mismatches << " compiled blocks differed from the interpreter" << std::endl;
+    return total_mismatches > 0;
+}
\ No newline at end of file
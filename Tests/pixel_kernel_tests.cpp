@@ -0,0 +1,60 @@
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include "Hardware/pixel_kernels.hpp"
+
+
+// Checks that every instruction set's kernels give the same results as the scalar kernels
+// The kernels are run on randomised tile data and palettes, over lengths which leave a partial vector at the end
+// Instruction sets which weren't compiled in fall back to the scalar kernels, so are checked against themselves
+
+
+static int total_failures = 0;
+
+
+static void check(bool is_passing, int instruction_set, const char* kernel, int length) {
+    if (is_passing) return;
+    if (++total_failures > 20) return;
+    std::cerr << "Error: " << kernel << " differs from the scalar kernel for instruction set " << instruction_set << " on " << length << " inputs" << std::endl;
+}
+
+
+int main() {
+    std::mt19937 random(0x5049);
+    Hardware::PixelKernels kernels;
+    Hardware::PixelKernels scalar_kernels;
+    scalar_kernels.select(Hardware::PixelKernels::SCALAR);
+    U8 tile_data[384 * 16];
+    U8 color_ids[384 * 64];
+    U8 expected[384 * 64];
+    U8 actual[384 * 64];
+
+    for (int instruction_set = Hardware::PixelKernels::SSE2; instruction_set <= Hardware::PixelKernels::AVX2; instruction_set++) {
+        kernels.select(instruction_set);
+
+        for (int i = 0; i < 500; i++) {
+            for (U8& u8 : tile_data) u8 = random();
+            for (U8& u8 : color_ids) u8 = random() & 3;
+            int total_rows = random() % (384 * 8 + 1);
+            int total_pixels = random() % (384 * 64 + 1);
+            U8 palette = random();
+
+            std::memset(expected, 0, total_rows * 8);
+            std::memset(actual, 0, total_rows * 8);
+            scalar_kernels.decode_tile_rows(tile_data, expected, total_rows);
+            kernels.decode_tile_rows(tile_data, actual, total_rows);
+            check(std::memcmp(expected, actual, total_rows * 8) == 0, instruction_set, "decode_tile_rows", total_rows);
+
+            scalar_kernels.map_colors(color_ids, expected, total_pixels, palette);
+            kernels.map_colors(color_ids, actual, total_pixels, palette);
+            check(std::memcmp(expected, actual, total_pixels) == 0, instruction_set, "map_colors", total_pixels);
+        }
+    }
+
+    // Reports which kernels the emulator picks on this machine
+    Hardware::PixelKernels selected_kernels;
+    std::cout << "Selected instruction set: " << selected_kernels.instruction_set << std::endl;
+    if (total_failures > 0) std::cerr << total_failures << " pixel kernel checks failed" << std::endl;
+    return total_failures > 0;
+}
\ No newline at end of file
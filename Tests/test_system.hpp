@@ -0,0 +1,96 @@
+#pragma once
+
+
+#include <string>
+#include <iostream>
+#include "Hardware/cpu.hpp"
+#include "Hardware/mmu.hpp"
+#include "Hardware/ppu.hpp"
+#include "Hardware/lcd.hpp"
+#include "Hardware/timer.hpp"
+#include "Hardware/cartridge.hpp"
+#include "Hardware/joypad.hpp"
+
+
+// The Gameboy's hardware without the window or settings, for running the CPU directly in the tests
+// The MMU and timer are declared first, as their constructors only store references while the other components' constructors use them
+// The components are reset in the same order as in Gameboy
+class TestSystem {
+public:
+    static constexpr int ticks_per_frame = 70224;
+    Hardware::MMU mmu;
+    Hardware::Timer timer;
+    Hardware::CPU cpu;
+    Hardware::Cartridge cartridge;
+    Hardware::Joypad joypad;
+    Hardware::LCD lcd;
+    Hardware::PPU ppu;
+
+    TestSystem() :
+        mmu(cpu, ppu, cartridge, joypad, timer, "."),
+        timer(mmu, cpu),
+        cpu(mmu),
+        cartridge(timer),
+        joypad(cpu),
+        ppu(mmu, lcd, cpu) {
+        reset();
+    }
+
+
+    // The hardware is too large for the stack, so each test shares a single static instance
+    static TestSystem& get_instance() {
+        static TestSystem test_system;
+        return test_system;
+    }
+
+
+    void reset() {
+        cpu.reset();
+        mmu.reset();
+        ppu.reset();
+        lcd.reset();
+        timer.reset();
+        cartridge.reset();
+        joypad.reset();
+        mmu.set_bootstrap_enabled(false);
+    }
+
+
+    // Runs a single opcode through the CPU's handler table, prefixed opcodes being 0x1XX
+    int run_opcode(int opcode) {return cpu.dispatch(Hardware::CPU::opcode_handlers[opcode]);}
+
+
+    // The cartridge prints its header when inserted, which would bury the results
+    void insert_rom(std::string rom_path) {
+        reset();
+        std::streambuf* output = std::cout.rdbuf(nullptr);
+        cartridge.insert(rom_path);
+        std::cout.rdbuf(output);
+        cpu.program_counter = 0x100;
+    }
+
+
+    // Presses start and A now and then, so that the games get past their title screens
+    void update_input(int frame) {
+        if (frame % 120 == 60) joypad.press_button(3);
+        if (frame % 120 == 70) joypad.joypad_button_states |= 8;
+        if (frame % 50 == 25) joypad.press_button(0);
+        if (frame % 50 == 30) joypad.joypad_button_states |= 1;
+    }
+
+
+    // Clocks the components in the same order as CPU::run_frame, with run_instruction standing in for CPU::run
+    template <typename RunInstruction>
+    void run_frame(RunInstruction run_instruction) {
+        while (cpu.ticks < ticks_per_frame) {
+            int last_instruction_ticks = run_instruction(ticks_per_frame - cpu.ticks);
+            cpu.ticks += last_instruction_ticks;
+            timer.run(last_instruction_ticks);
+            if (timer.total_ticks >= ppu.next_event_tick) ppu.run(cpu.last_instruction_count);
+            mmu.run_dma(last_instruction_ticks);
+            cpu.handle_interrupts();
+        }
+
+        cpu.ticks -= ticks_per_frame;
+    }
+};
\ No newline at end of file
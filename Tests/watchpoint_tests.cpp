@@ -0,0 +1,91 @@
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "test_system.hpp"
+
+
+// Checks that read, write and execute watchpoints each stop the frame at the expected program counter
+// A small ROM is written out which reads from and writes to work RAM, then runs into a breakpoint
+// Read and write watchpoints stop after the instruction accessing memory, while breakpoints stop before the instruction is run
+
+
+static TestSystem& test_system = TestSystem::get_instance();
+static int total_failures = 0;
+
+
+static const std::vector<U8> program = {
+    0xFA, 0x01, 0xC0, // LD A, (0xC001)
+    0x3E, 0x42, 0xEA, 0x00, 0xC0, // LD A, 0x42, LD (0xC000), A
+    0x00, 0x00, // NOP, NOP
+    0x18, 0xFE // JR -2
+};
+
+
+static const int program_address = 0x150;
+
+
+static std::string write_rom() {
+    std::vector<char> rom(0x8000, 0);
+    rom[0x100] = 0x00; // NOP
+    rom[0x101] = (char)0xC3; // JP 0x0150
+    rom[0x102] = program_address & 0xFF;
+    rom[0x103] = program_address >> 8;
+    std::copy(program.begin(), program.end(), rom.begin() + program_address);
+    std::string file_path = (std::filesystem::temp_directory_path() / "antboy_watchpoint_tests.gb").string();
+    std::ofstream file(file_path, std::ios::binary);
+    file.write(rom.data(), rom.size());
+    return file_path;
+}
+
+
+// Runs a frame, which should stop at the given watchpoint with the program counter at expected_pc
+static void check_stop(std::string name, Hardware::Watchpoints::Type type, U16 address, U16 expected_pc) {
+    Hardware::CPU& cpu = test_system.cpu;
+    Hardware::Watchpoints& watchpoints = test_system.mmu.watchpoints;
+    bool is_frame_completed = cpu.run_frame(TestSystem::ticks_per_frame);
+
+    if (!is_frame_completed && watchpoints.is_hit && watchpoints.hit_type == type && watchpoints.hit_address == address && cpu.program_counter == expected_pc) {
+        watchpoints.resume();
+        return;
+    }
+
+    total_failures++;
+    std::cerr << "Error: The " << name << " stopped with the PC at 0x" << std::hex << std::uppercase << std::setfill('0') << std::setw(4) << cpu.program_counter;
+    std::cerr << std::dec << (watchpoints.is_hit ? "\n" + watchpoints.get_report() : " without a hit") << std::endl;
+    watchpoints.resume();
+}
+
+
+int main() {
+    Hardware::CPU& cpu = test_system.cpu;
+    Hardware::Watchpoints& watchpoints = test_system.mmu.watchpoints;
+    std::string file_path = write_rom();
+    test_system.insert_rom(file_path);
+    std::filesystem::remove(file_path);
+    watchpoints.add(Hardware::Watchpoints::READ, 0xC001);
+    watchpoints.add(Hardware::Watchpoints::WRITE, 0xC000);
+    watchpoints.add(Hardware::Watchpoints::EXECUTE, program_address + 9);
+
+    check_stop("read watchpoint", Hardware::Watchpoints::READ, 0xC001, program_address + 3);
+    check_stop("write watchpoint", Hardware::Watchpoints::WRITE, 0xC000, program_address + 8);
+    check_stop("breakpoint", Hardware::Watchpoints::EXECUTE, program_address + 9, program_address + 9);
+
+    // The rest of the frame runs once resumed, as the loop at the end never reaches the watched addresses again
+    if (!cpu.run_frame(TestSystem::ticks_per_frame)) {
+        total_failures++;
+        std::cerr << "Error: The frame stopped again after the last watchpoint was resumed" << std::endl;
+    }
+
+    if (test_system.mmu.read_u8(0xC000) != 0x42) {
+        total_failures++;
+        std::cerr << "Error: The watched write didn't complete" << std::endl;
+    }
+
+    watchpoints.clear();
+    if (total_failures > 0) std::cerr << total_failures << " watchpoint checks failed" << std::endl;
+    return total_failures > 0;
+}
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Hardware/bus_tracer.hpp"
+
+
+// Reads a bus trace written by Hardware::BusTracer and reports how often each region of memory and each I/O register was accessed
+
+
+struct AccessCounts {
+    unsigned long long reads = 0;
+    unsigned long long writes = 0;
+};
+
+
+const std::vector<std::pair<U16, std::string>> regions = {
+    {0x0000, "ROM bank 0"},
+    {0x4000, "Switchable ROM bank"},
+    {0x8000, "Video RAM"},
+    {0xA000, "Cartridge RAM"},
+    {0xC000, "Work RAM"},
+    {0xE000, "Echo RAM"},
+    {0xFE00, "OAM"},
+    {0xFEA0, "Unusable"},
+    {0xFF00, "I/O registers"},
+    {0xFF80, "High RAM"},
+    {0xFFFF, "Interrupt enabled register"}
+};
+
+
+const std::map<U16, std::string> io_register_names = {
+    {0xFF00, "JOYP"}, {0xFF01, "SB"}, {0xFF02, "SC"}, {0xFF04, "DIV"}, {0xFF05, "TIMA"}, {0xFF06, "TMA"}, {0xFF07, "TAC"}, {0xFF0F, "IF"},
+    {0xFF10, "NR10"}, {0xFF11, "NR11"}, {0xFF12, "NR12"}, {0xFF13, "NR13"}, {0xFF14, "NR14"}, {0xFF16, "NR21"}, {0xFF17, "NR22"},
+    {0xFF18, "NR23"}, {0xFF19, "NR24"}, {0xFF1A, "NR30"}, {0xFF1B, "NR31"}, {0xFF1C, "NR32"}, {0xFF1D, "NR33"}, {0xFF1E, "NR34"},
+    {0xFF20, "NR41"}, {0xFF21, "NR42"}, {0xFF22, "NR43"}, {0xFF23, "NR44"}, {0xFF24, "NR50"}, {0xFF25, "NR51"}, {0xFF26, "NR52"},
+    {0xFF40, "LCDC"}, {0xFF41, "STAT"}, {0xFF42, "SCY"}, {0xFF43, "SCX"}, {0xFF44, "LY"}, {0xFF45, "LYC"}, {0xFF46, "DMA"},
+    {0xFF47, "BGP"}, {0xFF48, "OBP0"}, {0xFF49, "OBP1"}, {0xFF4A, "WY"}, {0xFF4B, "WX"}, {0xFF50, "BOOT"}, {0xFFFF, "IE"}
+};
+
+
+int get_region(U16 address) {
+    int region = 0;
+    while (region + 1 < (int)regions.size() && address >= regions[region + 1].first) region++;
+    return region;
+}
+
+
+void print_counts(std::string name, AccessCounts& counts) {
+    std::cout << "    " << std::left << std::setw(28) << name << std::right;
+    std::cout << std::setw(14) << counts.reads << " reads" << std::setw(14) << counts.writes << " writes\n";
+}
+
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: trace_analyzer <trace file>" << std::endl;
+        return 1;
+    }
+
+    std::ifstream file(argv[1], std::ios::binary);
+    char magic[4];
+    uint32_t version = 0;
+    file.read(magic, 4);
+    file.read((char*)&version, 4);
+
+    if (!file || std::memcmp(magic, Hardware::BusTracer::magic, 4) != 0 || version != Hardware::BusTracer::version) {
+        std::cerr << "Error: " << argv[1] << " isn't a supported bus trace" << std::endl;
+        return 1;
+    }
+
+    std::vector<AccessCounts> source_counts(3);
+    std::vector<AccessCounts> region_counts(regions.size());
+    std::map<U16, AccessCounts> io_register_counts;
+    std::vector<Hardware::BusTracer::Record> records(Hardware::BusTracer::buffer_size);
+    unsigned long long total_records = 0;
+    unsigned long long total_cycles = 0;
+    uint32_t previous_cycle = 0;
+
+    // The trace is read in chunks as a full game session can hold billions of records
+    while (file.read((char*)records.data(), records.size() * sizeof(Hardware::BusTracer::Record)) || file.gcount() > 0) {
+        size_t total_chunk_records = file.gcount() / sizeof(Hardware::BusTracer::Record);
+
+        for (size_t i = 0; i < total_chunk_records; i++) {
+            Hardware::BusTracer::Record& record = records[i];
+            bool is_write = record.flags & 1;
+            int source = (record.flags >> 1) & 3;
+            if (source > 2) continue;
+            total_cycles += (uint32_t)(record.cycle - previous_cycle); // Unwraps the 32-bit cycle, which only ever moves forwards
+            previous_cycle = record.cycle;
+            AccessCounts& source_count = source_counts[source];
+            AccessCounts& region_count = region_counts[get_region(record.address)];
+            (is_write ? source_count.writes : source_count.reads)++;
+            (is_write ? region_count.writes : region_count.reads)++;
+
+            if ((record.address >= 0xFF00 && record.address < 0xFF80) || record.address == 0xFFFF) {
+                AccessCounts& io_register_count = io_register_counts[record.address];
+                (is_write ? io_register_count.writes : io_register_count.reads)++;
+            }
+        }
+
+        total_records += total_chunk_records;
+    }
+
+    std::cout << "Records: " << total_records << "\n";
+    std::cout << "Cycles: " << total_cycles << "\n";
+    std::cout << "Accesses by source:\n";
+    print_counts("CPU", source_counts[Hardware::BusTracer::FROM_CPU]);
+    print_counts("PPU", source_counts[Hardware::BusTracer::FROM_PPU]);
+    print_counts("DMA", source_counts[Hardware::BusTracer::FROM_DMA]);
+    std::cout << "Accesses by region:\n";
+    for (int i = 0; i < (int)regions.size(); i++) print_counts(regions[i].second, region_counts[i]);
+    std::cout << "Accesses by I/O register:\n";
+
+    for (auto& [address, counts] : io_register_counts) {
+        std::stringstream name;
+        name << "0x" << std::hex << std::uppercase << std::setfill('0') << std::setw(4) << address;
+        if (io_register_names.count(address)) name << " " << io_register_names.at(address);
+        print_counts(name.str(), counts);
+    }
+
+    return 0;
+}
\ No newline at end of file